@@ -0,0 +1,186 @@
+#include "infra/simdcast.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace inf;
+
+static constexpr size_t s_count = 1024 * 1024;
+
+// The scalar loops as used by gdal::io::cast_raster before vectorization
+
+template <typename TSource, typename TDest>
+static void cast_scalar(const std::vector<TSource>& src, std::vector<TDest>& dst)
+{
+    for (size_t i = 0; i < src.size(); ++i) {
+        dst[i] = static_cast<TDest>(src[i]);
+    }
+}
+
+template <typename TSource>
+static void cast_nodata_to_nan_scalar(const std::vector<TSource>& src, double nodata, std::vector<float>& dst)
+{
+    for (size_t i = 0; i < src.size(); ++i) {
+        if (src[i] == nodata) {
+            dst[i] = std::numeric_limits<float>::quiet_NaN();
+        } else {
+            dst[i] = static_cast<float>(src[i]);
+        }
+    }
+}
+
+template <typename TDest>
+static void cast_nan_to_nodata_scalar(const std::vector<float>& src, double srcNodata, TDest dstNodata, std::vector<TDest>& dst)
+{
+    for (size_t i = 0; i < src.size(); ++i) {
+        if (std::isnan(src[i]) || src[i] == srcNodata) {
+            dst[i] = dstNodata;
+        } else {
+            dst[i] = static_cast<TDest>(src[i]);
+        }
+    }
+}
+
+template <typename T>
+static std::vector<T> create_data()
+{
+    std::vector<T> data(s_count);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<T>(i % 200);
+    }
+
+    return data;
+}
+
+static std::vector<float> create_float_data_with_nan()
+{
+    auto data = create_data<float>();
+    for (size_t i = 0; i < data.size(); i += 7) {
+        data[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+
+    return data;
+}
+
+static void set_processed_bytes(benchmark::State& state, size_t bytesPerElement)
+{
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(s_count * bytesPerElement));
+}
+
+template <typename TSource, typename TDest>
+static void castScalar(benchmark::State& state)
+{
+    auto src = create_data<TSource>();
+    std::vector<TDest> dst(src.size());
+
+    for (auto _ : state) {
+        cast_scalar(src, dst);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    set_processed_bytes(state, sizeof(TSource) + sizeof(TDest));
+}
+
+template <typename TSource, typename TDest>
+static void castSimd(benchmark::State& state)
+{
+    auto src = create_data<TSource>();
+    std::vector<TDest> dst(src.size());
+
+    for (auto _ : state) {
+        simd::cast(std::span<const TSource>(src), std::span<TDest>(dst));
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    set_processed_bytes(state, sizeof(TSource) + sizeof(TDest));
+}
+
+template <typename TSource>
+static void nodataToNanScalar(benchmark::State& state)
+{
+    auto src = create_data<TSource>();
+    std::vector<float> dst(src.size());
+
+    for (auto _ : state) {
+        cast_nodata_to_nan_scalar(src, 100.0, dst);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    set_processed_bytes(state, sizeof(TSource) + sizeof(float));
+}
+
+template <typename TSource>
+static void nodataToNanSimd(benchmark::State& state)
+{
+    auto src = create_data<TSource>();
+    std::vector<float> dst(src.size());
+
+    for (auto _ : state) {
+        simd::cast_nodata_to_nan(std::span<const TSource>(src), TSource(100), std::span<float>(dst));
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    set_processed_bytes(state, sizeof(TSource) + sizeof(float));
+}
+
+template <typename TDest>
+static void nanToNodataScalar(benchmark::State& state)
+{
+    auto src = create_float_data_with_nan();
+    std::vector<TDest> dst(src.size());
+
+    for (auto _ : state) {
+        cast_nan_to_nodata_scalar<TDest>(src, 100.0, TDest(255), dst);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    set_processed_bytes(state, sizeof(float) + sizeof(TDest));
+}
+
+template <typename TDest>
+static void nanToNodataSimd(benchmark::State& state)
+{
+    auto src = create_float_data_with_nan();
+    std::vector<TDest> dst(src.size());
+
+    for (auto _ : state) {
+        simd::cast_nan_to_nodata(std::span<const float>(src), 100.f, TDest(255), std::span<TDest>(dst));
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    set_processed_bytes(state, sizeof(float) + sizeof(TDest));
+}
+
+BENCHMARK_TEMPLATE(castScalar, float, double);
+BENCHMARK_TEMPLATE(castSimd, float, double);
+BENCHMARK_TEMPLATE(castScalar, double, float);
+BENCHMARK_TEMPLATE(castSimd, double, float);
+BENCHMARK_TEMPLATE(castScalar, int32_t, float);
+BENCHMARK_TEMPLATE(castSimd, int32_t, float);
+BENCHMARK_TEMPLATE(castScalar, float, int32_t);
+BENCHMARK_TEMPLATE(castSimd, float, int32_t);
+BENCHMARK_TEMPLATE(castScalar, uint8_t, float);
+BENCHMARK_TEMPLATE(castSimd, uint8_t, float);
+BENCHMARK_TEMPLATE(castScalar, float, uint8_t);
+BENCHMARK_TEMPLATE(castSimd, float, uint8_t);
+
+BENCHMARK_TEMPLATE(nodataToNanScalar, int32_t);
+BENCHMARK_TEMPLATE(nodataToNanSimd, int32_t);
+BENCHMARK_TEMPLATE(nodataToNanScalar, uint8_t);
+BENCHMARK_TEMPLATE(nodataToNanSimd, uint8_t);
+
+BENCHMARK_TEMPLATE(nanToNodataScalar, int32_t);
+BENCHMARK_TEMPLATE(nanToNodataSimd, int32_t);
+BENCHMARK_TEMPLATE(nanToNodataScalar, uint8_t);
+BENCHMARK_TEMPLATE(nanToNodataSimd, uint8_t);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,171 @@
+#include "infra/gdal.h"
+#include "infra/gdalaggregate.h"
+#include "infra/gdalalgo.h"
+#include "infra/gdalio.h"
+#include "infra/gdalwarpplan.h"
+#include "rasterdata.h"
+
+#include <benchmark/benchmark.h>
+#include <cpl_vsi.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace inf;
+using namespace inf::bench;
+
+template <gdal::ResampleAlgorithm Algo>
+static void warpRaster(benchmark::State& state)
+{
+    auto meta    = create_metadata(int32_t(state.range(0)));
+    auto data    = create_data<float>(meta);
+    auto dstMeta = gdal::warp_metadata(meta, 4326);
+    std::vector<float> result(size_t(dstMeta.rows) * size_t(dstMeta.cols));
+
+    for (auto _ : state) {
+        gdal::warp_raster<float, float>(data, meta, result, dstMeta, Algo);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed_cells(state, dstMeta, sizeof(float));
+}
+
+template <gdal::ResampleAlgorithm Algo>
+static void warpPlan(benchmark::State& state)
+{
+    auto meta    = create_metadata(int32_t(state.range(0)));
+    auto data    = create_data<float>(meta);
+    auto dstMeta = gdal::warp_metadata(meta, 4326);
+    std::vector<float> result(size_t(dstMeta.rows) * size_t(dstMeta.cols));
+
+    gdal::WarpPlan plan(meta, dstMeta, Algo);
+    for (auto _ : state) {
+        plan.apply<float, float>(data, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed_cells(state, dstMeta, sizeof(float));
+}
+
+static void polygonize(benchmark::State& state)
+{
+    auto meta = create_metadata(int32_t(state.range(0)));
+    auto data = create_data<int32_t>(meta);
+
+    for (auto _ : state) {
+        auto ds = gdal::polygonize(std::span<const int32_t>(data), meta);
+        benchmark::DoNotOptimize(ds.layer_count());
+    }
+
+    set_processed_cells(state, meta, sizeof(int32_t));
+}
+
+static void rasterize(benchmark::State& state)
+{
+    auto meta    = create_metadata(int32_t(state.range(0)));
+    auto data    = create_data<int32_t>(meta);
+    auto shapes  = gdal::polygonize(std::span<const int32_t>(data), meta);
+    auto options = std::vector<std::string>{"-a", "Value"};
+
+    for (auto _ : state) {
+        auto result = gdal::rasterize<int32_t>(shapes, meta, options);
+        benchmark::DoNotOptimize(result.second.data());
+    }
+
+    set_processed_cells(state, meta, sizeof(int32_t));
+}
+
+static void rasterizeTiled(benchmark::State& state)
+{
+    auto meta = create_metadata(int32_t(state.range(0)));
+    auto data = create_data<int32_t>(meta);
+
+    const std::string vectorPath = "/vsimem/rasterizebench.gpkg";
+    gdal::translate_vector_to_disk(gdal::polygonize(std::span<const int32_t>(data), meta), vectorPath, {"-f", "GPKG"});
+
+    auto options = std::vector<std::string>{"-a", "Value"};
+    gdal::RasterizeTileOptions tileOptions;
+    tileOptions.tileSize = 256;
+
+    std::vector<int32_t> result(data.size());
+    for (auto _ : state) {
+        gdal::rasterize_tiled<int32_t>(vectorPath, meta, result, options, tileOptions);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed_cells(state, meta, sizeof(int32_t));
+    VSIUnlink(vectorPath.c_str());
+}
+
+static void translateToDisk(benchmark::State& state)
+{
+    auto meta = create_metadata(int32_t(state.range(0)));
+    auto data = create_data<float>(meta);
+    auto ds   = gdal::io::create_memory_dataset(std::span<const float>(data), meta);
+
+    const std::string path = "/vsimem/translatebench.tif";
+    const std::vector<std::string> options{"-of", "GTiff", "-co", "COMPRESS=LZW", "-co", "TILED=YES"};
+    for (auto _ : state) {
+        auto result = gdal::translate(ds, path, options);
+        benchmark::DoNotOptimize(result.get());
+    }
+
+    set_processed_cells(state, meta, sizeof(float));
+    VSIUnlink(path.c_str());
+}
+
+static void translateResampled(benchmark::State& state)
+{
+    auto meta = create_metadata(int32_t(state.range(0)));
+    auto data = create_data<float>(meta);
+    auto ds   = gdal::io::create_memory_dataset(std::span<const float>(data), meta);
+
+    auto dstMeta = meta;
+    dstMeta.rows /= 2;
+    dstMeta.cols /= 2;
+    dstMeta.cellSize *= 2.0;
+
+    const std::vector<std::string> options{"-r", "average"};
+    for (auto _ : state) {
+        auto result = gdal::translate<float>(ds, dstMeta, options);
+        benchmark::DoNotOptimize(result.second.data());
+    }
+
+    set_processed_cells(state, meta, sizeof(float));
+}
+
+template <gdal::ResampleAlgorithm Algo>
+static void aggregateRaster(benchmark::State& state)
+{
+    auto meta    = create_metadata(int32_t(state.range(0)));
+    auto data    = create_data<float>(meta);
+    auto dstMeta = gdal::aggregate_metadata(meta, 2);
+    std::vector<float> result(size_t(dstMeta.rows) * size_t(dstMeta.cols));
+
+    for (auto _ : state) {
+        gdal::aggregate_raster<float, float>(data, meta, 2, result, Algo);
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    set_processed_cells(state, meta, sizeof(float));
+}
+
+BENCHMARK_TEMPLATE(warpRaster, gdal::ResampleAlgorithm::NearestNeighbour)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(warpRaster, gdal::ResampleAlgorithm::Bilinear)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(warpRaster, gdal::ResampleAlgorithm::Average)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(warpPlan, gdal::ResampleAlgorithm::NearestNeighbour)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(warpPlan, gdal::ResampleAlgorithm::Bilinear)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(warpPlan, gdal::ResampleAlgorithm::Average)->Apply(raster_sizes);
+BENCHMARK(polygonize)->Apply(raster_sizes);
+BENCHMARK(rasterize)->Apply(raster_sizes);
+BENCHMARK(rasterizeTiled)->Apply(raster_sizes);
+BENCHMARK(translateToDisk)->Apply(raster_sizes);
+BENCHMARK(translateResampled)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(aggregateRaster, gdal::ResampleAlgorithm::Average)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(aggregateRaster, gdal::ResampleAlgorithm::Maximum)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(aggregateRaster, gdal::ResampleAlgorithm::Mode)->Apply(raster_sizes);
+
+int main(int argc, char** argv)
+{
+    return run_benchmarks(argc, argv);
+}
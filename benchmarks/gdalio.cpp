@@ -0,0 +1,131 @@
+#include "infra/gdal.h"
+#include "infra/gdalio.h"
+#include "rasterdata.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cpl_vsi.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace inf;
+using namespace inf::bench;
+
+static const std::string s_readPath = "/vsimem/readbench.tif";
+
+static GeoMetadata create_read_dataset(int32_t size)
+{
+    auto meta = create_metadata(size);
+    auto data = create_data<float>(meta);
+    gdal::io::write_raster(std::span<const float>(data), meta, s_readPath);
+    return meta;
+}
+
+template <typename T>
+static void readRaster(benchmark::State& state)
+{
+    auto meta = create_read_dataset(int32_t(state.range(0)));
+    std::vector<T> data(size_t(meta.rows) * size_t(meta.cols));
+
+    for (auto _ : state) {
+        auto ds = gdal::RasterDataSet::open(s_readPath);
+        gdal::io::read_raster_data<T>(ds, std::span<T>(data));
+        benchmark::DoNotOptimize(data.data());
+    }
+
+    set_processed_cells(state, meta, sizeof(T));
+    VSIUnlink(s_readPath.c_str());
+}
+
+template <typename T>
+static void readRasterExtent(benchmark::State& state)
+{
+    auto meta = create_read_dataset(int32_t(state.range(0)));
+
+    // extent of half the raster size that only partially overlaps the raster, so the nodata fill is also measured
+    auto extent = meta;
+    extent.rows /= 2;
+    extent.cols /= 2;
+    extent.xll -= extent.cols / 2 * meta.cellSize.x;
+    extent.yll += (meta.rows - extent.rows / 2) * std::abs(meta.cellSize.y);
+
+    std::vector<T> data(size_t(extent.rows) * size_t(extent.cols));
+
+    for (auto _ : state) {
+        auto ds = gdal::RasterDataSet::open(s_readPath);
+        gdal::io::read_raster_data<T>(ds, extent, std::span<T>(data));
+        benchmark::DoNotOptimize(data.data());
+    }
+
+    set_processed_cells(state, extent, sizeof(T));
+    VSIUnlink(s_readPath.c_str());
+}
+
+static std::string_view raster_extension(gdal::RasterType type)
+{
+    switch (type) {
+    case gdal::RasterType::ArcAscii:
+        return ".asc";
+    case gdal::RasterType::Png:
+        return ".png";
+    default:
+        return ".tif";
+    }
+}
+
+template <typename T, gdal::RasterType Type>
+static void writeRaster(benchmark::State& state)
+{
+    auto meta = create_metadata(int32_t(state.range(0)));
+    auto data = create_data<T>(meta);
+
+    const auto path = "/vsimem/writebench" + std::string(raster_extension(Type));
+    for (auto _ : state) {
+        gdal::io::write_raster(std::span<const T>(data), meta, path);
+    }
+
+    set_processed_cells(state, meta, sizeof(T));
+    VSIUnlink(path.c_str());
+}
+
+template <typename TSource, typename TDest>
+static void castRaster(benchmark::State& state)
+{
+    auto meta = create_metadata(int32_t(state.range(0)));
+    auto src  = create_data<TSource>(meta);
+    std::vector<TDest> dst(src.size());
+
+    for (auto _ : state) {
+        gdal::io::cast_raster<TSource, TDest>(meta, std::span<const TSource>(src), std::span<TDest>(dst));
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    set_processed_cells(state, meta, sizeof(TSource) + sizeof(TDest));
+}
+
+BENCHMARK_TEMPLATE(readRaster, float)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(readRaster, int32_t)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(readRaster, uint8_t)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(readRasterExtent, float)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(readRasterExtent, uint8_t)->Apply(raster_sizes);
+
+BENCHMARK_TEMPLATE(writeRaster, float, gdal::RasterType::GeoTiff)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(writeRaster, double, gdal::RasterType::GeoTiff)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(writeRaster, int32_t, gdal::RasterType::GeoTiff)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(writeRaster, uint8_t, gdal::RasterType::GeoTiff)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(writeRaster, float, gdal::RasterType::ArcAscii)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(writeRaster, int32_t, gdal::RasterType::ArcAscii)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(writeRaster, uint8_t, gdal::RasterType::Png)->Apply(raster_sizes);
+
+BENCHMARK_TEMPLATE(castRaster, float, double)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(castRaster, int32_t, float)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(castRaster, float, uint8_t)->Apply(raster_sizes);
+BENCHMARK_TEMPLATE(castRaster, uint8_t, float)->Apply(raster_sizes);
+
+int main(int argc, char** argv)
+{
+    return run_benchmarks(argc, argv);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "infra/gdal.h"
+#include "infra/geometadata.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace inf::bench {
+
+// Synthetic rasters for the gdal benchmarks, the size is passed as the first benchmark argument
+
+inline constexpr int64_t s_minRasterSize = 256;
+inline constexpr int64_t s_maxRasterSize = 4096;
+
+/*! Benchmark arguments: square rasters from s_minRasterSize to s_maxRasterSize cells wide */
+inline void raster_sizes(benchmark::internal::Benchmark* bench)
+{
+    bench->RangeMultiplier(4)->Range(s_minRasterSize, s_maxRasterSize)->Unit(benchmark::kMillisecond);
+}
+
+inline GeoMetadata create_metadata(int32_t size)
+{
+    return GeoMetadata(size, size, 22000.0, 153000.0, 100.0, -1.0, "EPSG:31370");
+}
+
+/*! Raster with square patches of equal values, which gives a realistic amount of polygons when polygonizing */
+template <typename T>
+std::vector<T> create_data(const GeoMetadata& meta, int32_t patchSize = 16)
+{
+    std::vector<T> data(size_t(meta.rows) * size_t(meta.cols));
+    for (int32_t r = 0; r < meta.rows; ++r) {
+        for (int32_t c = 0; c < meta.cols; ++c) {
+            data[size_t(r) * meta.cols + c] = static_cast<T>(((r / patchSize) * 7 + (c / patchSize) * 3) % 100);
+        }
+    }
+
+    return data;
+}
+
+inline void set_processed_cells(benchmark::State& state, const GeoMetadata& meta, size_t bytesPerCell)
+{
+    const auto cells = int64_t(meta.rows) * int64_t(meta.cols);
+    state.SetItemsProcessed(int64_t(state.iterations()) * cells);
+    state.SetBytesProcessed(int64_t(state.iterations()) * cells * int64_t(bytesPerCell));
+}
+
+/*! Replacement for BENCHMARK_MAIN that keeps gdal registered while the benchmarks run
+ * Use --benchmark_out=<file> --benchmark_out_format=json to obtain results that can be compared between runs
+ */
+inline int run_benchmarks(int argc, char** argv)
+{
+    gdal::Registration reg;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+}
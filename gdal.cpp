@@ -14,6 +14,7 @@
 #include <array>
 #include <cassert>
 #include <gdal_version.h>
+#include <numeric>
 #include <ogrsf_frmts.h>
 #include <stdexcept>
 #include <unordered_map>
@@ -287,6 +288,11 @@ RasterDataSet RasterDriver::create_dataset_copy(const RasterDataSet& reference,
                                        "Failed to create data set copy"));
 }
 
+bool RasterDriver::supports_create() const
+{
+    return CPLFetchBool(_driver.GetMetadata(), GDAL_DCAP_CREATE, false);
+}
+
 RasterType RasterDriver::type() const
 {
     try {
@@ -741,16 +747,63 @@ const std::type_info& RasterDataSet::band_datatype(int bandNr) const
 
 void RasterDataSet::read_rasterdata(int band, int xOff, int yOff, int xSize, int ySize, const std::type_info& type, void* pData, int bufXSize, int bufYSize, int pixelSize, int lineSize) const
 {
+    IoMetricsScope metrics(IoOperation::Read, _ptr, uint64_t(bufXSize) * uint64_t(bufYSize) * GDALGetDataTypeSizeBytes(resolve_type(type)));
     auto* bandPtr = _ptr->GetRasterBand(band);
     check_error(bandPtr->RasterIO(GF_Read, xOff, yOff, xSize, ySize, pData, bufXSize, bufYSize, resolve_type(type), pixelSize, lineSize), "Failed to read raster data");
 }
 
 void RasterDataSet::write_rasterdata(int band, int xOff, int yOff, int xSize, int ySize, const std::type_info& type, const void* pData, int bufXSize, int bufYSize) const
 {
+    IoMetricsScope metrics(IoOperation::Write, _ptr, uint64_t(bufXSize) * uint64_t(bufYSize) * GDALGetDataTypeSizeBytes(resolve_type(type)));
     auto* bandPtr = _ptr->GetRasterBand(band);
     check_error(bandPtr->RasterIO(GF_Write, xOff, yOff, xSize, ySize, const_cast<void*>(pData), bufXSize, bufYSize, resolve_type(type), 0, 0), "Failed to write raster data");
 }
 
+static void multiband_rasterio(GDALDataset* ds, GDALRWFlag rwFlag, std::span<const int> bands, int xOff, int yOff, int xSize, int ySize, const std::type_info& type, void* pData, int bufXSize, int bufYSize, BandInterleave interleave)
+{
+    std::vector<int> bandList(bands.begin(), bands.end());
+    if (bandList.empty()) {
+        bandList.resize(ds->GetRasterCount());
+        std::iota(bandList.begin(), bandList.end(), 1);
+    }
+
+    const auto dataType  = resolve_type(type);
+    const auto typeSize  = GSpacing(GDALGetDataTypeSizeBytes(dataType));
+    const auto bandCount = truncate<int>(bandList.size());
+
+    IoMetricsScope metrics(rwFlag == GF_Read ? IoOperation::Read : IoOperation::Write, ds, uint64_t(bufXSize) * uint64_t(bufYSize) * uint64_t(typeSize) * uint64_t(bandCount));
+
+    GSpacing pixelSpace = typeSize;
+    GSpacing lineSpace  = typeSize * bufXSize;
+    GSpacing bandSpace  = lineSpace * bufYSize;
+    if (interleave == BandInterleave::Pixel) {
+        pixelSpace = typeSize * bandCount;
+        lineSpace  = pixelSpace * bufXSize;
+        bandSpace  = typeSize;
+    }
+
+    check_error(ds->RasterIO(rwFlag, xOff, yOff, xSize, ySize, pData, bufXSize, bufYSize, dataType, bandCount, bandList.data(), pixelSpace, lineSpace, bandSpace, nullptr),
+                rwFlag == GF_Read ? "Failed to read raster data" : "Failed to write raster data");
+}
+
+void RasterDataSet::read_rasterdata(std::span<const int> bands, int xOff, int yOff, int xSize, int ySize, const std::type_info& type, void* pData, int bufXSize, int bufYSize, BandInterleave interleave) const
+{
+    multiband_rasterio(_ptr, GF_Read, bands, xOff, yOff, xSize, ySize, type, pData, bufXSize, bufYSize, interleave);
+}
+
+void RasterDataSet::write_rasterdata(std::span<const int> bands, int xOff, int yOff, int xSize, int ySize, const std::type_info& type, const void* pData, int bufXSize, int bufYSize, BandInterleave interleave) const
+{
+    multiband_rasterio(_ptr, GF_Write, bands, xOff, yOff, xSize, ySize, type, const_cast<void*>(pData), bufXSize, bufYSize, interleave);
+}
+
+void RasterDataSet::check_multiband_buffer_size(std::span<const int> bands, size_t bufferSize, int bufXSize, int bufYSize) const
+{
+    const auto bandCount = bands.empty() ? size_t(raster_count()) : bands.size();
+    if (bufferSize != size_t(bufXSize) * size_t(bufYSize) * bandCount) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size ({} <-> {}x{}x{})", bufferSize, bufXSize, bufYSize, bandCount);
+    }
+}
+
 void RasterDataSet::write_geometadata(const GeoMetadata& meta)
 {
     set_geotransform(metadata_to_geo_transform(meta));
@@ -3,14 +3,27 @@
 #include "infra/enumutils.h"
 #include "infra/exception.h"
 #include "infra/gdalio.h"
+#include "infra/gdalmetrics.h"
+#include "infra/parallelfor.h"
 #include "infra/string.h"
 
 #include <cassert>
 #include <gdal_alg.h>
 #include <gdal_utils.h>
+#include <mutex>
 
 namespace inf::gdal {
 
+static uint64_t raster_size_in_bytes(GDALDataset* ds) noexcept
+{
+    if (ds == nullptr || ds->GetRasterCount() == 0) {
+        return 0;
+    }
+
+    const auto typeSize = GDALGetDataTypeSizeBytes(ds->GetRasterBand(1)->GetRasterDataType());
+    return uint64_t(ds->GetRasterXSize()) * uint64_t(ds->GetRasterYSize()) * uint64_t(ds->GetRasterCount()) * uint64_t(typeSize);
+}
+
 void warp(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, ResampleAlgorithm algo)
 {
     WarpOptions options;
@@ -18,12 +31,17 @@ void warp(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, ResampleAl
     return warp(srcDataSet, dstDataSet, options);
 }
 
-void warp(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, WarpOptions& options)
+static void warp_dataset(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, WarpOptions& options, const WarpChunkOptions* chunkOptions)
 {
     std::vector<std::string> strOptions = {
         "NUM_THREADS=ALL_CPUS",
     };
 
+    if (chunkOptions != nullptr) {
+        // the destination is not kept in memory, so it needs to be initialized for every chunk
+        strOptions.emplace_back("INIT_DEST=NO_DATA");
+    }
+
     strOptions.reserve(strOptions.size() + options.additionalOptions.size());
     std::copy(options.additionalOptions.begin(), options.additionalOptions.end(), std::back_inserter(strOptions));
 
@@ -39,6 +57,10 @@ void warp(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, WarpOption
     warpOptions->pfnTransformer   = GDALGenImgProjTransform;
     warpOptions->eResampleAlg     = GDALResampleAlg(enum_value(options.resampleAlgo));
 
+    if (chunkOptions != nullptr) {
+        warpOptions->dfWarpMemoryLimit = chunkOptions->memoryLimit;
+    }
+
     if (options.clipPolygon.get() != nullptr) {
         warpOptions->hCutline = options.clipPolygon.get()->clone();
     }
@@ -68,14 +90,35 @@ void warp(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, WarpOption
                                                                                        FALSE, 0.0, 0),
                                                        "Failed to create actual warping transformer");
 
+    IoMetricsScope metrics(IoOperation::Warp, srcDataSet.get(), raster_size_in_bytes(dstDataSet.get()));
+
     GDALWarpOperation operation;
     operation.Initialize(warpOptions);
-    check_error(operation.ChunkAndWarpImage(0, 0, dstDataSet.x_size(), dstDataSet.y_size()), "Failed to warp raster");
+    if (chunkOptions != nullptr && chunkOptions->overlapIo) {
+        check_error(operation.ChunkAndWarpMulti(0, 0, dstDataSet.x_size(), dstDataSet.y_size()), "Failed to warp raster");
+    } else {
+        check_error(operation.ChunkAndWarpImage(0, 0, dstDataSet.x_size(), dstDataSet.y_size()), "Failed to warp raster");
+    }
 
     GDALDestroyGenImgProjTransformer(warpOptions->pTransformerArg);
     GDALDestroyWarpOptions(warpOptions);
 }
 
+void warp(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, WarpOptions& options)
+{
+    warp_dataset(srcDataSet, dstDataSet, options, nullptr);
+}
+
+void warp_chunked(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, WarpOptions& options, const WarpChunkOptions& chunkOptions)
+{
+    if (chunkOptions.memoryLimit <= 0.0) {
+        throw InvalidArgument("Invalid warp memory limit: {}", chunkOptions.memoryLimit);
+    }
+
+    warp_dataset(srcDataSet, dstDataSet, options, &chunkOptions);
+    dstDataSet.flush_cache();
+}
+
 class GdalWarpAppOptionsWrapper
 {
 public:
@@ -118,6 +161,8 @@ void warp_cli(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, const
         warpOptions.set_option(key.c_str(), value.c_str());
     }
 
+    IoMetricsScope metrics(IoOperation::Warp, srcDataSet.get(), raster_size_in_bytes(dstDataSet.get()));
+
     int usageError = 0;
     auto srcHandle = GDALDataset::ToHandle(srcDataSet.get());
     GDALWarp(nullptr, GDALDataset::ToHandle(dstDataSet.get()), 1, &srcHandle, warpOptions, &usageError);
@@ -135,12 +180,16 @@ void warp_cli(const RasterDataSet& srcDataSet, const fs::path& output, const std
         warpOptions.set_option(key.c_str(), value.c_str());
     }
 
+    IoMetricsScope metrics(IoOperation::Warp, srcDataSet.get());
+
     int usageError = 0;
     auto srcHandle = GDALDataset::ToHandle(srcDataSet.get());
     RasterDataSet rasterDs(GDALWarp(file::generic_u8string(output).c_str(), nullptr, 1, &srcHandle, warpOptions, &usageError));
     if (usageError) {
         throw RuntimeError("Warp failed");
     }
+
+    metrics.set_bytes(raster_size_in_bytes(rasterDs.get()));
 }
 
 VectorDataSet warp_vector(const fs::path& vectorPath, const GeoMetadata& destMeta, const std::vector<std::string>& extraOptions)
@@ -281,6 +330,8 @@ std::pair<GeoMetadata, std::vector<T>> rasterize(const VectorDataSet& ds, const
     memDataSet.set_nodata_value(1, meta.nodata);
     memDataSet.set_projection(meta.projection);
 
+    IoMetricsScope metrics(IoOperation::Rasterize, ds.get(), data.size() * sizeof(T));
+
     int errorCode = CE_None;
     GDALRasterize(nullptr, memDataSet.get(), ds.get(), gdalOptions.get(), &errorCode);
     if (errorCode != CE_None) {
@@ -294,15 +345,122 @@ RasterDataSet rasterize_to_disk(const VectorDataSet& ds, const fs::path& path, c
 {
     RasterizeOptionsWrapper gdalOptions(options);
 
+    IoMetricsScope metrics(IoOperation::Rasterize, ds.get());
+
     int errorCode = CE_None;
     RasterDataSet rasterDs(GDALRasterize(file::generic_u8string(path).c_str(), nullptr, ds.get(), gdalOptions.get(), &errorCode));
     if (errorCode != CE_None) {
         throw RuntimeError("Failed to rasterize dataset {}", errorCode);
     }
 
+    metrics.set_bytes(raster_size_in_bytes(rasterDs.get()));
+
     return rasterDs;
 }
 
+// Rasterizes the tiles of the grid concurrently, the callback is invoked with the metadata, the offset and the data of every tile
+template <typename T, typename TileCallback>
+static void rasterize_tiles(const fs::path& vectorPath, const GeoMetadata& meta, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, TileCallback&& cb)
+{
+    if (tileOptions.tileSize <= 0) {
+        throw InvalidArgument("Invalid rasterize tile size: {}", tileOptions.tileSize);
+    }
+
+    // validate the options before starting the threads
+    RasterizeOptionsWrapper gdalOptions(options);
+
+    const auto tileSize   = tileOptions.tileSize;
+    const auto tileRows   = (meta.rows + tileSize - 1) / tileSize;
+    const auto tileCols   = (meta.cols + tileSize - 1) / tileSize;
+    const auto fillValue  = truncate<T>(meta.nodata.value_or(0.0));
+    const auto cellWidth  = meta.cellSize.x;
+    const auto cellHeight = std::abs(meta.cellSize.y);
+
+    parallel_for(
+        int64_t(tileRows) * tileCols, tileOptions.threadCount, [&]() { return VectorDataSet::open(vectorPath); },
+        [&](VectorDataSet& ds, int64_t tileIndex) {
+            const auto rowOffset = int32_t(tileIndex / tileCols) * tileSize;
+            const auto colOffset = int32_t(tileIndex % tileCols) * tileSize;
+
+            auto tileMeta = meta;
+            tileMeta.rows = std::min(tileSize, meta.rows - rowOffset);
+            tileMeta.cols = std::min(tileSize, meta.cols - colOffset);
+            tileMeta.xll  = meta.xll + colOffset * cellWidth;
+            tileMeta.yll  = meta.yll + (meta.rows - rowOffset - tileMeta.rows) * cellHeight;
+
+            // the filter is one cell larger than the tile so features that only touch the tile are also considered
+            auto bbox = tileMeta.bounding_box();
+            for (int32_t i = 0; i < ds.layer_count(); ++i) {
+                ds.layer(i).set_spatial_filter(Point<double>(bbox.topLeft.x - cellWidth, bbox.topLeft.y + cellHeight),
+                                               Point<double>(bbox.bottomRight.x + cellWidth, bbox.bottomRight.y - cellHeight));
+            }
+
+            std::vector<T> data(size_t(tileMeta.rows) * tileMeta.cols, fillValue);
+            auto memDriver = gdal::RasterDriver::create(gdal::RasterType::Memory);
+            gdal::RasterDataSet memDataSet(memDriver.create_dataset<T>(tileMeta.rows, tileMeta.cols, 0));
+            memDataSet.add_band(data.data());
+            memDataSet.set_geotransform(inf::metadata_to_geo_transform(tileMeta));
+            memDataSet.set_nodata_value(1, tileMeta.nodata);
+            memDataSet.set_projection(tileMeta.projection);
+
+            RasterizeOptionsWrapper tileGdalOptions(options);
+            int errorCode = CE_None;
+            GDALRasterize(nullptr, memDataSet.get(), ds.get(), tileGdalOptions.get(), &errorCode);
+            if (errorCode != CE_None) {
+                throw RuntimeError("Failed to rasterize dataset {}", errorCode);
+            }
+
+            cb(tileMeta, rowOffset, colOffset, std::span<const T>(data));
+        });
+}
+
+template <typename T>
+GeoMetadata rasterize_tiled(const fs::path& vectorPath, const GeoMetadata& meta, std::span<T> result, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions)
+{
+    if (truncate<int32_t>(result.size()) != meta.rows * meta.cols) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    const auto vectorName = file::generic_u8string(vectorPath);
+    IoMetricsScope metrics(IoOperation::Rasterize, vectorName.c_str(), result.size() * sizeof(T));
+
+    // the tiles do not overlap, so they can be copied in the result without synchronization
+    rasterize_tiles<T>(vectorPath, meta, options, tileOptions, [&](const GeoMetadata& tileMeta, int32_t rowOffset, int32_t colOffset, std::span<const T> tileData) {
+        for (int32_t row = 0; row < tileMeta.rows; ++row) {
+            auto tileRow = tileData.subspan(size_t(row) * tileMeta.cols, tileMeta.cols);
+            std::copy(tileRow.begin(), tileRow.end(), result.begin() + size_t(rowOffset + row) * meta.cols + colOffset);
+        }
+    });
+
+    return meta;
+}
+
+template <typename T>
+void rasterize_tiled_to_disk(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, const std::vector<std::string>& driverOptions)
+{
+    auto driver = RasterDriver::create(outputPath);
+    if (!driver.supports_create()) {
+        throw InvalidArgument("Tiled rasterization requires an output format that supports direct creation: {}", outputPath);
+    }
+
+    auto dstOptions = driverOptions.empty() ? io::detail::default_driver_options(driver) : driverOptions;
+    io::detail::create_output_directory_if_needed(outputPath);
+    auto dstDataSet = driver.create_dataset<T>(meta.rows, meta.cols, 1, outputPath, dstOptions);
+    dstDataSet.write_geometadata(meta);
+
+    const auto vectorName = file::generic_u8string(vectorPath);
+    IoMetricsScope metrics(IoOperation::Rasterize, vectorName.c_str(), uint64_t(meta.rows) * uint64_t(meta.cols) * sizeof(T));
+
+    // the dataset can only be written by one thread at a time
+    std::mutex writeMutex;
+    rasterize_tiles<T>(vectorPath, meta, options, tileOptions, [&](const GeoMetadata& tileMeta, int32_t rowOffset, int32_t colOffset, std::span<const T> tileData) {
+        std::scoped_lock lock(writeMutex);
+        dstDataSet.write_rasterdata(1, colOffset, rowOffset, tileMeta.cols, tileMeta.rows, tileData.data(), tileMeta.cols, tileMeta.rows);
+    });
+
+    dstDataSet.flush_cache();
+}
+
 class VectorTranslateOptionsWrapper
 {
 public:
@@ -453,6 +611,8 @@ std::pair<GeoMetadata, std::vector<T>> translate(const RasterDataSet& ds, const
     memDataSet.set_nodata_value(1, meta.nodata);
     memDataSet.set_projection(meta.projection);
 
+    IoMetricsScope metrics(IoOperation::Translate, ds.get(), data.size() * sizeof(T));
+
     int errorCode              = CE_None;
     GDALDatasetH srcDataSetPtr = ds.get();
     GDALWarp(nullptr, memDataSet.get(), 1, &srcDataSetPtr, gdalOptions.get(), &errorCode);
@@ -524,6 +684,8 @@ gdal::RasterDataSet translate(const gdal::RasterDataSet& ds, const fs::path& out
 
     io::detail::create_output_directory_if_needed(outputPath);
 
+    IoMetricsScope metrics(IoOperation::Translate, ds.get());
+
     int userError = 0;
     auto resultDs = gdal::RasterDataSet(GDALTranslate(outputPath.empty() ? nullptr : file::generic_u8string(outputPath).c_str(), ds.get(), gdalOptions.get(), &userError));
 
@@ -531,6 +693,8 @@ gdal::RasterDataSet translate(const gdal::RasterDataSet& ds, const fs::path& out
         throw RuntimeError("Translate: invalid arguments");
     }
 
+    metrics.set_bytes(raster_size_in_bytes(resultDs.get()));
+
     return resultDs;
 }
 
@@ -541,6 +705,20 @@ template std::pair<GeoMetadata, std::vector<int16_t>> rasterize<int16_t>(const V
 template std::pair<GeoMetadata, std::vector<uint16_t>> rasterize<uint16_t>(const VectorDataSet& ds, const GeoMetadata& meta, const std::vector<std::string>& options);
 template std::pair<GeoMetadata, std::vector<uint8_t>> rasterize<uint8_t>(const VectorDataSet& ds, const GeoMetadata& meta, const std::vector<std::string>& options);
 
+template GeoMetadata rasterize_tiled<float>(const fs::path& vectorPath, const GeoMetadata& meta, std::span<float> result, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions);
+template GeoMetadata rasterize_tiled<double>(const fs::path& vectorPath, const GeoMetadata& meta, std::span<double> result, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions);
+template GeoMetadata rasterize_tiled<int32_t>(const fs::path& vectorPath, const GeoMetadata& meta, std::span<int32_t> result, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions);
+template GeoMetadata rasterize_tiled<int16_t>(const fs::path& vectorPath, const GeoMetadata& meta, std::span<int16_t> result, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions);
+template GeoMetadata rasterize_tiled<uint16_t>(const fs::path& vectorPath, const GeoMetadata& meta, std::span<uint16_t> result, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions);
+template GeoMetadata rasterize_tiled<uint8_t>(const fs::path& vectorPath, const GeoMetadata& meta, std::span<uint8_t> result, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions);
+
+template void rasterize_tiled_to_disk<float>(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, const std::vector<std::string>& driverOptions);
+template void rasterize_tiled_to_disk<double>(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, const std::vector<std::string>& driverOptions);
+template void rasterize_tiled_to_disk<int32_t>(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, const std::vector<std::string>& driverOptions);
+template void rasterize_tiled_to_disk<int16_t>(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, const std::vector<std::string>& driverOptions);
+template void rasterize_tiled_to_disk<uint16_t>(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, const std::vector<std::string>& driverOptions);
+template void rasterize_tiled_to_disk<uint8_t>(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options, const RasterizeTileOptions& tileOptions, const std::vector<std::string>& driverOptions);
+
 template std::pair<GeoMetadata, std::vector<float>> translate<float>(const RasterDataSet& ds, const GeoMetadata& meta, const std::vector<std::string>& options);
 template std::pair<GeoMetadata, std::vector<double>> translate<double>(const RasterDataSet& ds, const GeoMetadata& meta, const std::vector<std::string>& options);
 template std::pair<GeoMetadata, std::vector<int32_t>> translate<int32_t>(const RasterDataSet& ds, const GeoMetadata& meta, const std::vector<std::string>& options);
@@ -0,0 +1,80 @@
+#include "infra/gdalasyncwriter.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace inf::gdal::io {
+
+AsyncRasterWriter::AsyncRasterWriter(uint32_t threadCount, size_t maxInFlightBytes)
+: _maxInFlightBytes(maxInFlightBytes)
+{
+    _pool.start(std::max(1u, threadCount));
+}
+
+AsyncRasterWriter::~AsyncRasterWriter()
+{
+    wait_until_finished();
+    _pool.stop_finish_jobs();
+}
+
+size_t AsyncRasterWriter::queue_depth() const
+{
+    std::scoped_lock lock(_mutex);
+    return _queueDepth;
+}
+
+size_t AsyncRasterWriter::in_flight_bytes() const
+{
+    std::scoped_lock lock(_mutex);
+    return _inFlightBytes;
+}
+
+size_t AsyncRasterWriter::max_in_flight_bytes() const noexcept
+{
+    return _maxInFlightBytes;
+}
+
+void AsyncRasterWriter::wait_until_finished()
+{
+    std::unique_lock lock(_mutex);
+    _condition.wait(lock, [this]() { return _queueDepth == 0; });
+}
+
+std::future<void> AsyncRasterWriter::submit(size_t bytes, std::function<void()> write)
+{
+    {
+        // wait for room, a write that exceeds the limit on its own is accepted when nothing else is pending
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this, bytes]() { return _queueDepth == 0 || _inFlightBytes + bytes <= _maxInFlightBytes; });
+        _inFlightBytes += bytes;
+        ++_queueDepth;
+    }
+
+    auto promise = std::make_shared<std::promise<void>>();
+    auto result  = promise->get_future();
+
+    _pool.add_job([this, bytes, promise, write = std::move(write)]() mutable {
+        try {
+            write();
+            promise->set_value();
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+
+        // release the raster data before signaling that there is room for new writes
+        write = nullptr;
+
+        {
+            std::scoped_lock lock(_mutex);
+            assert(_queueDepth > 0 && _inFlightBytes >= bytes);
+            _inFlightBytes -= bytes;
+            --_queueDepth;
+        }
+
+        _condition.notify_all();
+    });
+
+    return result;
+}
+
+}
@@ -0,0 +1,238 @@
+#include "infra/gdaldatasetcache.h"
+#include "infra/exception.h"
+#include "infra/gdalio.h"
+
+#include <cassert>
+#include <system_error>
+
+namespace inf::gdal {
+
+static std::string create_key(std::string_view type, OpenMode mode, const fs::path& filePath, const std::vector<std::string>& driverOpts)
+{
+    std::string key(type);
+    key += mode == OpenMode::ReadOnly ? "|r|" : "|w|";
+    key += filePath.generic_string();
+    for (auto& opt : driverOpts) {
+        key += '|';
+        key += opt;
+    }
+
+    return key;
+}
+
+static int64_t modification_time(const fs::path& filePath)
+{
+    if (io::is_vsi_path(filePath)) {
+        // stat calls on virtual file systems can be expensive (e.g. network requests)
+        return 0;
+    }
+
+    std::error_code ec;
+    auto time = fs::last_write_time(filePath, ec);
+    if (ec) {
+        return 0;
+    }
+
+    return time.time_since_epoch().count();
+}
+
+DataSetCache& DataSetCache::instance()
+{
+    static DataSetCache cache;
+    return cache;
+}
+
+DataSetCache::DataSetCache(size_t maxHandles)
+: _maxHandles(maxHandles)
+{
+}
+
+DataSetCache::~DataSetCache()
+{
+    assert(_stats.leases == 0);
+}
+
+void DataSetCache::set_max_handles(size_t maxHandles)
+{
+    std::vector<Handle> closedHandles;
+
+    {
+        std::scoped_lock lock(_mutex);
+        _maxHandles = maxHandles;
+        evict_until_within_handle_limit(0, closedHandles);
+    }
+}
+
+size_t DataSetCache::max_handles() const
+{
+    std::scoped_lock lock(_mutex);
+    return _maxHandles;
+}
+
+RasterDataSetLease DataSetCache::open_raster(const fs::path& filePath, OpenMode mode, const std::vector<std::string>& driverOpts)
+{
+    auto key     = create_key("raster", mode, filePath, driverOpts);
+    auto modTime = modification_time(filePath);
+
+    if (auto handle = take_idle_handle(key, modTime); handle.has_value()) {
+        return RasterDataSetLease(this, std::move(key), modTime, std::get<RasterDataSet>(std::move(*handle)));
+    }
+
+    try {
+        auto ds = mode == OpenMode::ReadOnly ? RasterDataSet::open(filePath, driverOpts) : RasterDataSet::open_for_writing(filePath, driverOpts);
+        return RasterDataSetLease(this, std::move(key), modTime, std::move(ds));
+    } catch (...) {
+        abandon_lease();
+        throw;
+    }
+}
+
+VectorDataSetLease DataSetCache::open_vector(const fs::path& filePath, OpenMode mode, const std::vector<std::string>& driverOpts)
+{
+    auto key     = create_key("vector", mode, filePath, driverOpts);
+    auto modTime = modification_time(filePath);
+
+    if (auto handle = take_idle_handle(key, modTime); handle.has_value()) {
+        return VectorDataSetLease(this, std::move(key), modTime, std::get<VectorDataSet>(std::move(*handle)));
+    }
+
+    try {
+        auto ds = mode == OpenMode::ReadOnly ? VectorDataSet::open(filePath, driverOpts) : VectorDataSet::open_for_writing(filePath, driverOpts);
+        return VectorDataSetLease(this, std::move(key), modTime, std::move(ds));
+    } catch (...) {
+        abandon_lease();
+        throw;
+    }
+}
+
+GeoMetadata DataSetCache::read_metadata(const fs::path& filePath, const std::vector<std::string>& driverOpts)
+{
+    return open_raster(filePath, OpenMode::ReadOnly, driverOpts)->geometadata();
+}
+
+GeoMetadata DataSetCache::read_metadata(const fs::path& filePath, int bandNr, const std::vector<std::string>& driverOpts)
+{
+    return open_raster(filePath, OpenMode::ReadOnly, driverOpts)->geometadata(bandNr);
+}
+
+const std::type_info& DataSetCache::get_raster_type(const fs::path& filePath)
+{
+    auto ds    = open_raster(filePath);
+    auto& type = ds->band_datatype(1);
+    if (type == typeid(void)) {
+        throw RuntimeError("Unsupported raster data type");
+    }
+
+    return type;
+}
+
+void DataSetCache::clear()
+{
+    std::list<IdleEntry> closedHandles;
+
+    {
+        std::scoped_lock lock(_mutex);
+        _stats.evictions += _idle.size();
+        _idleLookup.clear();
+        closedHandles.swap(_idle);
+    }
+
+    // the handles are closed when going out of scope, outside of the lock
+}
+
+DataSetCacheStats DataSetCache::stats() const
+{
+    std::scoped_lock lock(_mutex);
+    auto stats        = _stats;
+    stats.idleHandles = _idle.size();
+    return stats;
+}
+
+void DataSetCache::reset_stats()
+{
+    std::scoped_lock lock(_mutex);
+    _stats.hits      = 0;
+    _stats.misses    = 0;
+    _stats.evictions = 0;
+}
+
+std::optional<DataSetCache::Handle> DataSetCache::take_idle_handle(const std::string& key, int64_t modificationTime)
+{
+    std::optional<Handle> result;
+    std::vector<Handle> closedHandles;
+
+    std::scoped_lock lock(_mutex);
+    auto [begin, end] = _idleLookup.equal_range(key);
+    for (auto iter = begin; iter != end;) {
+        auto entry = iter->second;
+        if (entry->modificationTime != modificationTime) {
+            // the file was modified since the handle was opened
+            closedHandles.push_back(std::move(entry->handle));
+            _idle.erase(entry);
+            iter = _idleLookup.erase(iter);
+            ++_stats.evictions;
+        } else if (!result.has_value()) {
+            result = std::move(entry->handle);
+            _idle.erase(entry);
+            iter = _idleLookup.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    if (result.has_value()) {
+        ++_stats.hits;
+    } else {
+        ++_stats.misses;
+        // make room for the handle that will be opened
+        evict_until_within_handle_limit(1, closedHandles);
+    }
+
+    ++_stats.leases;
+    return result;
+}
+
+void DataSetCache::return_handle(std::string key, int64_t modificationTime, Handle handle) noexcept
+{
+    std::vector<Handle> closedHandles;
+
+    std::scoped_lock lock(_mutex);
+    assert(_stats.leases > 0);
+    --_stats.leases;
+
+    try {
+        _idle.push_front(IdleEntry{std::move(key), modificationTime, std::move(handle)});
+        _idleLookup.emplace(_idle.front().key, _idle.begin());
+        evict_until_within_handle_limit(0, closedHandles);
+    } catch (const std::exception&) {
+        // failed to store the handle, it will be closed
+    }
+}
+
+void DataSetCache::abandon_lease() noexcept
+{
+    std::scoped_lock lock(_mutex);
+    assert(_stats.leases > 0);
+    --_stats.leases;
+}
+
+void DataSetCache::evict_until_within_handle_limit(size_t reserved, std::vector<Handle>& closedHandles)
+{
+    while (!_idle.empty() && _idle.size() + _stats.leases + reserved > _maxHandles) {
+        auto entry = std::prev(_idle.end());
+
+        auto [begin, end] = _idleLookup.equal_range(entry->key);
+        for (auto iter = begin; iter != end; ++iter) {
+            if (iter->second == entry) {
+                _idleLookup.erase(iter);
+                break;
+            }
+        }
+
+        closedHandles.push_back(std::move(entry->handle));
+        _idle.erase(entry);
+        ++_stats.evictions;
+    }
+}
+
+}
@@ -2,10 +2,16 @@
 #include "infra/cast.h"
 #include "infra/exception.h"
 #include "infra/filesystem.h"
+#include "infra/scopeguard.h"
 #include "infra/string.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <gdal_vrt.h>
+#include <tuple>
 #include <typeindex>
+#include <unordered_map>
 
 namespace inf::gdal::io {
 
@@ -59,6 +65,433 @@ void detail::read_raster_data(int bandNr, CutOut cut, const gdal::RasterDataSet&
     dataSet.read_rasterdata(bandNr, std::max(0, cut.srcColOffset), std::max(0, cut.srcRowOffset), cut.cols, cut.rows, typeInfo, data, cut.cols, cut.rows, 0, truncate<int>(dataCols * typeSize));
 }
 
+detail::ResampledWindow detail::intersect_metadata_resampled(const GeoMetadata& srcMeta, const GeoMetadata& dstMeta)
+{
+    if (srcMeta.cellSize.x == 0 || srcMeta.cellSize.y == 0 || dstMeta.cellSize.x == 0 || dstMeta.cellSize.y == 0) {
+        throw InvalidArgument("Extents cellsize is zero");
+    }
+
+    // the number of source pixels per destination cell
+    const auto scaleX = dstMeta.cellSize.x / srcMeta.cellSize.x;
+    const auto scaleY = dstMeta.cellSize.y / srcMeta.cellSize.y;
+    if (scaleX < 0 || scaleY < 0) {
+        throw InvalidArgument("Extents cellsize orientation does not match {} <-> {}", srcMeta.cellSize, dstMeta.cellSize);
+    }
+
+    // top left of the destination in source pixel coordinates
+    const auto srcX0 = srcMeta.convert_x_to_col_fraction(dstMeta.top_left().x);
+    const auto srcY0 = srcMeta.convert_y_to_row_fraction(dstMeta.top_left().y);
+
+    // the destination cells of which the centre is located in the source raster
+    const auto firstCol = std::clamp(static_cast<int>(std::ceil(-srcX0 / scaleX - 0.5)), 0, dstMeta.cols);
+    const auto endCol   = std::clamp(static_cast<int>(std::ceil((srcMeta.cols - srcX0) / scaleX - 0.5)), firstCol, dstMeta.cols);
+    const auto firstRow = std::clamp(static_cast<int>(std::ceil(-srcY0 / scaleY - 0.5)), 0, dstMeta.rows);
+    const auto endRow   = std::clamp(static_cast<int>(std::ceil((srcMeta.rows - srcY0) / scaleY - 0.5)), firstRow, dstMeta.rows);
+
+    ResampledWindow result;
+    result.dstColOffset = firstCol;
+    result.dstRowOffset = firstRow;
+    result.cols         = endCol - firstCol;
+    result.rows         = endRow - firstRow;
+
+    // the edge cells can extend slightly beyond the raster, gdal requires the window to be located inside the raster
+    const auto srcLeft   = std::max(0.0, srcX0 + firstCol * scaleX);
+    const auto srcRight  = std::min(double(srcMeta.cols), srcX0 + endCol * scaleX);
+    const auto srcTop    = std::max(0.0, srcY0 + firstRow * scaleY);
+    const auto srcBottom = std::min(double(srcMeta.rows), srcY0 + endRow * scaleY);
+
+    result.srcColOffset = srcLeft;
+    result.srcRowOffset = srcTop;
+    result.srcCols      = std::max(0.0, srcRight - srcLeft);
+    result.srcRows      = std::max(0.0, srcBottom - srcTop);
+
+    return result;
+}
+
+static GDALRIOResampleAlg rasterio_resample_algorithm(ResampleAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case ResampleAlgorithm::NearestNeighbour:
+        return GRIORA_NearestNeighbour;
+    case ResampleAlgorithm::Bilinear:
+        return GRIORA_Bilinear;
+    case ResampleAlgorithm::Cubic:
+        return GRIORA_Cubic;
+    case ResampleAlgorithm::CubicSpline:
+        return GRIORA_CubicSpline;
+    case ResampleAlgorithm::Lanczos:
+        return GRIORA_Lanczos;
+    case ResampleAlgorithm::Average:
+        return GRIORA_Average;
+    case ResampleAlgorithm::Mode:
+        return GRIORA_Mode;
+#if GDAL_VERSION_NUM >= 3010000
+    case ResampleAlgorithm::RootMeanSquare:
+        return GRIORA_RMS;
+#endif
+    default:
+        throw InvalidArgument("Resample algorithm is not supported for reading: {}", resample_algo_to_string(algorithm));
+    }
+}
+
+void detail::read_raster_data_resampled(int bandNr, const ResampledWindow& window, ResampleAlgorithm algorithm, const gdal::RasterDataSet& dataSet, const std::type_info& typeInfo, void* data, int dataCols)
+{
+    assert(bandNr > 0);
+
+    if (window.rows == 0 || window.cols == 0) {
+        return;
+    }
+
+    auto band = dataSet.rasterband(bandNr);
+
+    // pick the coarsest overview that still has at least the requested resolution
+    auto* srcBand     = band.get();
+    double overviewX  = 1.0;
+    double overviewY  = 1.0;
+    const auto scaleX = window.srcCols / window.cols;
+    const auto scaleY = window.srcRows / window.rows;
+    for (int i = 0; i < band.overview_count(); ++i) {
+        auto overview        = band.overview_dataset(i);
+        const auto factorX   = double(band.x_size()) / overview.x_size();
+        const auto factorY   = double(band.y_size()) / overview.y_size();
+        const bool usable    = factorX <= scaleX * 1.001 && factorY <= scaleY * 1.001;
+        const bool isCoarser = factorX * factorY > overviewX * overviewY;
+        if (usable && isCoarser) {
+            srcBand   = overview.get();
+            overviewX = factorX;
+            overviewY = factorY;
+        }
+    }
+
+    GDALRasterIOExtraArg extraArg;
+    INIT_RASTERIO_EXTRA_ARG(extraArg);
+    extraArg.eResampleAlg                 = rasterio_resample_algorithm(algorithm);
+    extraArg.bFloatingPointWindowValidity = TRUE;
+    extraArg.dfXOff                       = window.srcColOffset / overviewX;
+    extraArg.dfYOff                       = window.srcRowOffset / overviewY;
+    extraArg.dfXSize                      = window.srcCols / overviewX;
+    extraArg.dfYSize                      = window.srcRows / overviewY;
+
+    const auto xOff  = std::clamp(static_cast<int>(std::floor(extraArg.dfXOff)), 0, srcBand->GetXSize() - 1);
+    const auto yOff  = std::clamp(static_cast<int>(std::floor(extraArg.dfYOff)), 0, srcBand->GetYSize() - 1);
+    const auto xSize = std::clamp(static_cast<int>(std::ceil(extraArg.dfXOff + extraArg.dfXSize)) - xOff, 1, srcBand->GetXSize() - xOff);
+    const auto ySize = std::clamp(static_cast<int>(std::ceil(extraArg.dfYOff + extraArg.dfYSize)) - yOff, 1, srcBand->GetYSize() - yOff);
+
+    const auto typeSize = GDALGetDataTypeSizeBytes(resolve_type(typeInfo));
+    auto* dataPtr       = static_cast<std::byte*>(data) + (size_t(window.dstRowOffset) * dataCols + window.dstColOffset) * typeSize;
+
+    check_error(srcBand->RasterIO(GF_Read, xOff, yOff, xSize, ySize, dataPtr, window.cols, window.rows, resolve_type(typeInfo), typeSize, GSpacing(dataCols) * typeSize, &extraArg),
+                "Failed to read resampled raster data");
+}
+
+std::vector<std::string> detail::tiled_geotiff_options(const TiledWriteOptions& options, const std::type_info& storageType)
+{
+    if (options.tileSize <= 0 || options.tileSize % 16 != 0) {
+        throw InvalidArgument("Tile size must be a multiple of 16: {}", options.tileSize);
+    }
+
+    std::vector<std::string> result = {
+        "TILED=YES",
+        fmt::format("BLOCKXSIZE={}", options.tileSize),
+        fmt::format("BLOCKYSIZE={}", options.tileSize),
+        "BIGTIFF=IF_SAFER",
+        options.threadCount == 0 ? std::string("NUM_THREADS=ALL_CPUS") : fmt::format("NUM_THREADS={}", options.threadCount),
+    };
+
+    switch (options.compression) {
+    case TiffCompression::None:
+        result.emplace_back("COMPRESS=NONE");
+        break;
+    case TiffCompression::Lzw:
+        result.emplace_back("COMPRESS=LZW");
+        break;
+    case TiffCompression::Deflate:
+        result.emplace_back("COMPRESS=DEFLATE");
+        if (options.compressionLevel > 0) {
+            result.emplace_back(fmt::format("ZLEVEL={}", options.compressionLevel));
+        }
+        break;
+    case TiffCompression::Zstd:
+        result.emplace_back("COMPRESS=ZSTD");
+        if (options.compressionLevel > 0) {
+            result.emplace_back(fmt::format("ZSTD_LEVEL={}", options.compressionLevel));
+        }
+        break;
+    }
+
+    if (options.predictor && options.compression != TiffCompression::None) {
+        const bool isFloatingPoint = storageType == typeid(float) || storageType == typeid(double);
+        result.emplace_back(isFloatingPoint ? "PREDICTOR=3" : "PREDICTOR=2");
+    }
+
+    // options provided by the caller take precedence, gdal uses the last occurrence of an option
+    result.insert(result.end(), options.driverOptions.begin(), options.driverOptions.end());
+    return result;
+}
+
+static std::string compression_name(TiffCompression compression)
+{
+    switch (compression) {
+    case TiffCompression::None:
+        return "NONE";
+    case TiffCompression::Lzw:
+        return "LZW";
+    case TiffCompression::Deflate:
+        return "DEFLATE";
+    case TiffCompression::Zstd:
+        return "ZSTD";
+    }
+
+    throw InvalidArgument("Invalid tiff compression");
+}
+
+static std::string thread_count_option(uint32_t threadCount)
+{
+    return threadCount == 0 ? std::string("ALL_CPUS") : std::to_string(threadCount);
+}
+
+void detail::write_cog(gdal::RasterDataSet memDataSet, const GeoMetadata& meta, const std::type_info& storageType, const fs::path& filename, const CogWriteOptions& options)
+{
+    if (options.tileSize <= 0 || options.tileSize % 16 != 0) {
+        throw InvalidArgument("Tile size must be a multiple of 16: {}", options.tileSize);
+    }
+
+    auto* cogDriver = check_pointer(GetGDALDriverManager()->GetDriverByName("COG"), "The COG driver is not available");
+
+    // overview levels until the overview fits in a single tile
+    std::vector<int32_t> levels;
+    const auto size = std::max(memDataSet.x_size(), memDataSet.y_size());
+    for (int32_t factor = 2; (size + factor / 2 - 1) / (factor / 2) > options.tileSize; factor *= 2) {
+        levels.push_back(factor);
+    }
+
+    if (!levels.empty()) {
+        // the overviews of a MEM dataset are kept in memory, GDAL_NUM_THREADS parallelizes their computation
+        const std::string previousThreads = CPLGetThreadLocalConfigOption("GDAL_NUM_THREADS", "");
+        CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", thread_count_option(options.threadCount).c_str());
+        ScopeGuard restoreThreads([&]() {
+            CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", previousThreads.empty() ? nullptr : previousThreads.c_str());
+        });
+
+        memDataSet.build_overviews(options.overviewResampling, levels);
+    }
+
+    std::vector<std::string> creationOptions = {
+        fmt::format("COMPRESS={}", compression_name(options.compression)),
+        fmt::format("BLOCKSIZE={}", options.tileSize),
+        fmt::format("NUM_THREADS={}", thread_count_option(options.threadCount)),
+        "OVERVIEWS=FORCE_USE_EXISTING",
+        "BIGTIFF=IF_SAFER",
+    };
+
+    if (options.compressionLevel > 0 && (options.compression == TiffCompression::Deflate || options.compression == TiffCompression::Zstd)) {
+        creationOptions.emplace_back(fmt::format("LEVEL={}", options.compressionLevel));
+    }
+
+    if (options.predictor && options.compression != TiffCompression::None) {
+        creationOptions.emplace_back("PREDICTOR=YES");
+    }
+
+    creationOptions.insert(creationOptions.end(), options.driverOptions.begin(), options.driverOptions.end());
+
+    if (storageType == memDataSet.band_datatype(1)) {
+        gdal::RasterDriver(*cogDriver).create_dataset_copy(memDataSet, filename, creationOptions);
+        return;
+    }
+
+    // the view exposes the overviews of the memory dataset as implicit overviews, converted to the storage type
+    auto view = create_raster_view(std::move(memDataSet), meta, storageType, {});
+    gdal::RasterDriver(*cogDriver).create_dataset_copy(view.dataset(), filename, creationOptions);
+}
+
+namespace {
+
+struct BlockRange
+{
+    int32_t left   = 0;
+    int32_t top    = 0;
+    int32_t right  = 0; // exclusive
+    int32_t bottom = 0; // exclusive
+
+    int64_t area() const noexcept
+    {
+        return int64_t(right - left) * int64_t(bottom - top);
+    }
+
+    BlockRange united(const BlockRange& other) const noexcept
+    {
+        return BlockRange{std::min(left, other.left), std::min(top, other.top), std::max(right, other.right), std::max(bottom, other.bottom)};
+    }
+};
+
+struct PendingGroup
+{
+    BlockRange blocks;
+    BlockRange cells;
+    int64_t blockArea = 0; // the number of blocks of the separate members, before merging
+    std::vector<size_t> members;
+};
+
+bool should_merge(const PendingGroup& lhs, const PendingGroup& rhs, int64_t maxCells) noexcept
+{
+    return lhs.blocks.united(rhs.blocks).area() <= lhs.blockArea + rhs.blockArea && lhs.cells.united(rhs.cells).area() <= maxCells;
+}
+
+void merge_group(PendingGroup& target, PendingGroup& source)
+{
+    target.blocks    = target.blocks.united(source.blocks);
+    target.cells     = target.cells.united(source.cells);
+    target.blockArea = target.blocks.area();
+    target.members.insert(target.members.end(), source.members.begin(), source.members.end());
+}
+
+}
+
+std::vector<detail::BatchReadGroup> detail::group_cutouts(std::span<const CutOut> cutOuts, Size blockSize, int64_t maxCells)
+{
+    const auto blockWidth  = std::max(1, blockSize.width);
+    const auto blockHeight = std::max(1, blockSize.height);
+
+    std::vector<PendingGroup> groups;
+    for (size_t i = 0; i < cutOuts.size(); ++i) {
+        auto& cutOut = cutOuts[i];
+        if (cutOut.rows <= 0 || cutOut.cols <= 0) {
+            continue;
+        }
+
+        PendingGroup group;
+        group.cells.left   = std::max(0, cutOut.srcColOffset);
+        group.cells.top    = std::max(0, cutOut.srcRowOffset);
+        group.cells.right  = group.cells.left + cutOut.cols;
+        group.cells.bottom = group.cells.top + cutOut.rows;
+        group.blocks       = BlockRange{
+            group.cells.left / blockWidth,
+            group.cells.top / blockHeight,
+            (group.cells.right - 1) / blockWidth + 1,
+            (group.cells.bottom - 1) / blockHeight + 1,
+        };
+        group.blockArea = group.blocks.area();
+        group.members.push_back(i);
+        groups.push_back(std::move(group));
+    }
+
+    // sort on the block position, so the groups of neighbouring blocks end up close to each other in the result
+    std::sort(groups.begin(), groups.end(), [](const PendingGroup& lhs, const PendingGroup& rhs) {
+        return std::tie(lhs.blocks.top, lhs.blocks.left) < std::tie(rhs.blocks.top, rhs.blocks.left);
+    });
+
+    // Groups with a gap of one or more blocks between them always have a larger merged block range than their separate
+    // block ranges combined, so only groups that overlap or share an edge with a group have to be considered for merging.
+    // The groups are registered in every block they cover, groups that are larger than the maximum can not be merged.
+    std::unordered_map<int64_t, std::vector<size_t>> blockGroups;
+    auto blockKey = [](int32_t col, int32_t row) {
+        return (int64_t(row) << 32) | int64_t(uint32_t(col));
+    };
+
+    auto registerGroup = [&](size_t index, const BlockRange& skip) {
+        auto& blocks = groups[index].blocks;
+        for (int32_t row = blocks.top; row < blocks.bottom; ++row) {
+            for (int32_t col = blocks.left; col < blocks.right; ++col) {
+                if (row < skip.top || row >= skip.bottom || col < skip.left || col >= skip.right) {
+                    blockGroups[blockKey(col, row)].push_back(index);
+                }
+            }
+        }
+    };
+
+    std::vector<bool> mergedAway(groups.size(), false);
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (groups[i].cells.area() <= maxCells) {
+            registerGroup(i, BlockRange());
+        }
+    }
+
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (mergedAway[i] || groups[i].cells.area() > maxCells) {
+            continue;
+        }
+
+        // merging grows the block range of the group, which can make it mergeable with groups that were not neighbours before
+        bool merged = true;
+        while (merged) {
+            merged = false;
+
+            const auto blocks = groups[i].blocks;
+            for (int32_t row = blocks.top - 1; row <= blocks.bottom; ++row) {
+                for (int32_t col = blocks.left - 1; col <= blocks.right; ++col) {
+                    auto iter = blockGroups.find(blockKey(col, row));
+                    if (iter == blockGroups.end()) {
+                        continue;
+                    }
+
+                    for (auto candidate : iter->second) {
+                        if (candidate != i && !mergedAway[candidate] && should_merge(groups[i], groups[candidate], maxCells)) {
+                            merge_group(groups[i], groups[candidate]);
+                            mergedAway[candidate] = true;
+                            merged                = true;
+                        }
+                    }
+                }
+            }
+
+            if (merged) {
+                registerGroup(i, blocks);
+            }
+        }
+    }
+
+    std::vector<BatchReadGroup> result;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (mergedAway[i]) {
+            continue;
+        }
+
+        auto& group = groups[i];
+        BatchReadGroup readGroup;
+        readGroup.colOffset = group.cells.left;
+        readGroup.rowOffset = group.cells.top;
+        readGroup.cols      = group.cells.right - group.cells.left;
+        readGroup.rows      = group.cells.bottom - group.cells.top;
+        readGroup.members   = std::move(group.members);
+        result.push_back(std::move(readGroup));
+    }
+
+    return result;
+}
+
+static bool same_nodata(std::optional<double> lhs, std::optional<double> rhs) noexcept
+{
+    if (lhs.has_value() && rhs.has_value() && std::isnan(*lhs) && std::isnan(*rhs)) {
+        return true;
+    }
+
+    return lhs == rhs;
+}
+
+RasterView detail::create_raster_view(gdal::RasterDataSet source, const GeoMetadata& meta, const std::type_info& viewType, const RasterViewOptions& options)
+{
+    auto vrtHandle = reinterpret_cast<GDALDatasetH>(VRTCreate(meta.cols, meta.rows));
+    gdal::RasterDataSet view(GDALDataset::FromHandle(check_pointer(vrtHandle, "Failed to create VRT dataset")));
+    check_error(GDALAddBand(vrtHandle, resolve_type(viewType), nullptr), "Failed to add VRT band");
+
+    auto vrtBand = reinterpret_cast<VRTSourcedRasterBandH>(GDALGetRasterBand(vrtHandle, 1));
+    auto srcBand = GDALGetRasterBand(GDALDataset::ToHandle(source.get()), 1);
+
+    auto viewMeta   = meta;
+    viewMeta.nodata = options.nodata.has_value() ? options.nodata : meta.nodata;
+
+    if (options.scale != 1.0 || options.offset != 0.0 || !same_nodata(meta.nodata, viewMeta.nodata)) {
+        // source nodata cells are skipped by the complex source, so they keep the nodata value of the view band
+        check_error(VRTAddComplexSource(vrtBand, srcBand, 0, 0, meta.cols, meta.rows, 0, 0, meta.cols, meta.rows, options.offset, options.scale, meta.nodata.value_or(VRT_NODATA_UNSET)),
+                    "Failed to add VRT source");
+    } else {
+        check_error(VRTAddSimpleSource(vrtBand, srcBand, 0, 0, meta.cols, meta.rows, 0, 0, meta.cols, meta.rows, nullptr, VRT_NODATA_UNSET), "Failed to add VRT source");
+    }
+
+    view.write_geometadata(viewMeta);
+    return RasterView(std::move(source), std::move(view));
+}
+
 void detail::create_output_directory_if_needed(const fs::path& p)
 {
     if (is_vsi_path(p)) {
@@ -0,0 +1,47 @@
+#include "infra/gdalmappedraster.h"
+#include "infra/gdal-private.h"
+
+#include <gdal_priv.h>
+
+namespace inf::gdal::detail {
+
+void VirtualMemDeleter::operator()(CPLVirtualMem* mem) const noexcept
+{
+    CPLVirtualMemFree(mem);
+}
+
+VirtualMemPtr map_raster_band(RasterDataSet& dataSet, int bandNr, const std::type_info& type)
+{
+    if (!CPLIsVirtualMemFileMapAvailable()) {
+        return nullptr;
+    }
+
+    auto band = dataSet.rasterband(bandNr);
+    if (band.get()->GetRasterDataType() != resolve_type(type)) {
+        return nullptr;
+    }
+
+    // Only accept the driver specific implementations that map the file,
+    // the default implementation copies the data into the mapped pages on access
+    CPLStringList options;
+    options.SetNameValue("USE_DEFAULT_IMPLEMENTATION", "NO");
+
+    int pixelSpace    = 0;
+    GIntBig lineSpace = 0;
+    VirtualMemPtr mem(band.get()->GetVirtualMemAuto(GF_Read, &pixelSpace, &lineSpace, options.List()));
+    if (!mem) {
+        // not being able to map the band is not an error, the caller falls back to a regular read
+        CPLErrorReset();
+        return nullptr;
+    }
+
+    const auto typeSize = GDALGetDataTypeSizeBytes(resolve_type(type));
+    if (pixelSpace != typeSize || lineSpace != GIntBig(typeSize) * band.x_size()) {
+        // interleaved bands or padded lines, the data is not contiguous
+        return nullptr;
+    }
+
+    return mem;
+}
+
+}
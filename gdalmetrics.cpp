@@ -0,0 +1,212 @@
+#include "infra/gdalmetrics.h"
+#include "infra/enumutils.h"
+#include "infra/string.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <gdal.h>
+#include <gdal_priv.h>
+
+#ifdef INFRA_LOG_ENABLED
+#include "infra/log.h"
+#endif
+
+namespace inf::gdal {
+
+std::string_view io_operation_name(IoOperation op) noexcept
+{
+    switch (op) {
+    case IoOperation::Read:
+        return "read";
+    case IoOperation::Write:
+        return "write";
+    case IoOperation::Warp:
+        return "warp";
+    case IoOperation::Translate:
+        return "translate";
+    case IoOperation::Rasterize:
+        return "rasterize";
+    case IoOperation::EnumCount:
+        break;
+    }
+
+    return "unknown";
+}
+
+void IoOperationMetrics::merge(const IoOperationMetrics& other) noexcept
+{
+    calls += other.calls;
+    bytes += other.bytes;
+    duration += other.duration;
+    peakCacheUsage = std::max(peakCacheUsage, other.peakCacheUsage);
+}
+
+IoMetrics& IoMetrics::instance()
+{
+    static IoMetrics s_instance;
+    return s_instance;
+}
+
+void IoMetrics::set_enabled(bool enabled) noexcept
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void IoMetrics::record(IoOperation op, std::string_view dataSet, uint64_t bytes, std::chrono::nanoseconds duration)
+{
+    const auto cacheUsage = GDALGetCacheUsed64();
+
+    std::scoped_lock lock(_mutex);
+    auto iter = _metrics.find(std::string(dataSet));
+    if (iter == _metrics.end()) {
+        iter = _metrics.emplace(std::string(dataSet), IoOperationMetricsArray()).first;
+    }
+
+    auto& metrics = iter->second[enum_value(op)];
+    ++metrics.calls;
+    metrics.bytes += bytes;
+    metrics.duration += duration;
+    metrics.peakCacheUsage = std::max(metrics.peakCacheUsage, int64_t(cacheUsage));
+}
+
+void IoMetrics::reset()
+{
+    std::scoped_lock lock(_mutex);
+    _metrics.clear();
+}
+
+std::vector<DataSetIoMetrics> IoMetrics::datasets() const
+{
+    std::vector<DataSetIoMetrics> result;
+
+    {
+        std::scoped_lock lock(_mutex);
+        result.reserve(_metrics.size());
+        for (auto& [name, operations] : _metrics) {
+            result.push_back(DataSetIoMetrics{name, operations});
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const DataSetIoMetrics& lhs, const DataSetIoMetrics& rhs) {
+        return lhs.name < rhs.name;
+    });
+
+    return result;
+}
+
+IoOperationMetricsArray IoMetrics::totals() const
+{
+    IoOperationMetricsArray result;
+
+    std::scoped_lock lock(_mutex);
+    for (auto& [name, operations] : _metrics) {
+        for (size_t i = 0; i < operations.size(); ++i) {
+            result[i].merge(operations[i]);
+        }
+    }
+
+    return result;
+}
+
+static std::string json_escape(std::string_view str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (auto c : str) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                result += fmt::format("\\u{:04x}", int(c));
+            } else {
+                result += c;
+            }
+        }
+    }
+
+    return result;
+}
+
+static std::string operations_to_json(const IoOperationMetricsArray& operations)
+{
+    std::vector<std::string> entries;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        auto& metrics = operations[i];
+        if (metrics.calls == 0) {
+            continue;
+        }
+
+        entries.push_back(fmt::format(R"("{}":{{"calls":{},"bytes":{},"duration_ms":{:.3f},"peak_cache_bytes":{}}})",
+                                      io_operation_name(IoOperation(i)),
+                                      metrics.calls,
+                                      metrics.bytes,
+                                      std::chrono::duration<double, std::milli>(metrics.duration).count(),
+                                      metrics.peakCacheUsage));
+    }
+
+    return fmt::format("{{{}}}", str::join(entries, ","));
+}
+
+std::string IoMetrics::to_json() const
+{
+    std::vector<std::string> dataSets;
+    for (auto& metrics : datasets()) {
+        dataSets.push_back(fmt::format(R"({{"name":"{}","operations":{}}})", json_escape(metrics.name), operations_to_json(metrics.operations)));
+    }
+
+    return fmt::format(R"({{"cache_used_bytes":{},"cache_max_bytes":{},"totals":{},"datasets":[{}]}})",
+                       GDALGetCacheUsed64(),
+                       GDALGetCacheMax64(),
+                       operations_to_json(totals()),
+                       str::join(dataSets, ","));
+}
+
+void IoMetrics::log() const
+{
+#ifdef INFRA_LOG_ENABLED
+    auto logOperations = [](std::string_view name, const IoOperationMetricsArray& operations) {
+        for (size_t i = 0; i < operations.size(); ++i) {
+            auto& metrics = operations[i];
+            if (metrics.calls > 0) {
+                Log::info("GDAL {} {}: {} calls, {} bytes, {:.3f} ms, peak cache {} bytes",
+                          name,
+                          io_operation_name(IoOperation(i)),
+                          metrics.calls,
+                          metrics.bytes,
+                          std::chrono::duration<double, std::milli>(metrics.duration).count(),
+                          metrics.peakCacheUsage);
+            }
+        }
+    };
+
+    logOperations("total", totals());
+    for (auto& metrics : datasets()) {
+        logOperations(metrics.name, metrics.operations);
+    }
+#endif
+}
+
+void IoMetricsScope::record() noexcept
+{
+    try {
+        const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+
+        const char* dataSet = _object != nullptr ? _object->GetDescription() : _dataSet;
+        IoMetrics::instance().record(_op, dataSet != nullptr ? dataSet : "", _bytes, duration);
+    } catch (...) {
+        // metrics must never make an operation fail
+    }
+}
+
+}
@@ -0,0 +1,373 @@
+#include "infra/gdalmosaic.h"
+#include "infra/cast.h"
+#include "infra/gdal-private.h"
+#include "infra/gdalspatialreference.h"
+#include "infra/math.h"
+#include "infra/string.h"
+
+#include <cmath>
+#include <fmt/format.h>
+#include <numeric>
+
+namespace inf::gdal {
+
+using namespace std::string_view_literals;
+
+static constexpr std::string_view s_indexHeader = "infra-raster-mosaic";
+static constexpr int32_t s_indexVersion         = 1;
+
+static Rect<double> united(const Rect<double>& lhs, const Rect<double>& rhs) noexcept
+{
+    return Rect<double>(Point<double>(std::min(lhs.topLeft.x, rhs.topLeft.x), std::max(lhs.topLeft.y, rhs.topLeft.y)),
+                        Point<double>(std::max(lhs.bottomRight.x, rhs.bottomRight.x), std::min(lhs.bottomRight.y, rhs.bottomRight.y)));
+}
+
+static Point<double> centre(const Rect<double>& rect) noexcept
+{
+    return Point<double>((rect.topLeft.x + rect.bottomRight.x) / 2.0, (rect.topLeft.y + rect.bottomRight.y) / 2.0);
+}
+
+/*! Sort tile recursive ordering: the items are sorted on x in vertical slices, which are sorted on y
+ * so consecutive runs of nodeCapacity items are spatially compact */
+template <typename Item, typename BBox>
+static void str_sort(std::vector<Item>& items, size_t nodeCapacity, BBox&& bbox)
+{
+    const auto nodeCount  = (items.size() + nodeCapacity - 1) / nodeCapacity;
+    const auto sliceCount = size_t(std::ceil(std::sqrt(double(nodeCount))));
+    const auto sliceSize  = sliceCount * nodeCapacity;
+
+    std::sort(items.begin(), items.end(), [&](const Item& lhs, const Item& rhs) {
+        return centre(bbox(lhs)).x < centre(bbox(rhs)).x;
+    });
+
+    for (size_t begin = 0; begin < items.size(); begin += sliceSize) {
+        const auto end = std::min(items.size(), begin + sliceSize);
+        std::sort(items.begin() + begin, items.begin() + end, [&](const Item& lhs, const Item& rhs) {
+            return centre(bbox(lhs)).y > centre(bbox(rhs)).y;
+        });
+    }
+}
+
+static bool same_projection(const std::string& lhs, const std::string& rhs)
+{
+    if (lhs == rhs) {
+        return true;
+    }
+
+    if (lhs.empty() || rhs.empty()) {
+        return false;
+    }
+
+    // the same projection can have a different wkt representation
+    try {
+        return SpatialReference(lhs).is_same(SpatialReference(rhs));
+    } catch (const RuntimeError&) {
+        return false;
+    }
+}
+
+static GeoMetadata mosaic_metadata(std::span<const MosaicTile> tiles)
+{
+    if (tiles.empty()) {
+        throw InvalidArgument("A raster mosaic needs at least one tile");
+    }
+
+    auto& first = tiles.front().metadata;
+    auto bbox   = first.bounding_box();
+    for (auto& tile : tiles) {
+        if (!math::approx_equal(tile.metadata.cellSize.x, first.cellSize.x, 1e-10) || !math::approx_equal(tile.metadata.cellSize.y, first.cellSize.y, 1e-10)) {
+            throw InvalidArgument("Mosaic tile {} has a different cell size ({} <-> {})", tile.path, tile.metadata.cellSize, first.cellSize);
+        }
+
+        if (!same_projection(tile.metadata.projection, first.projection)) {
+            throw InvalidArgument("Mosaic tile {} has a different projection than tile {}", tile.path, tiles.front().path);
+        }
+
+        bbox = united(bbox, tile.metadata.bounding_box());
+    }
+
+    auto meta = first;
+    meta.xll  = bbox.topLeft.x;
+    meta.yll  = bbox.bottomRight.y;
+    meta.cols = truncate<int32_t>(std::round(bbox.width() / first.cellSize.x));
+    meta.rows = truncate<int32_t>(std::round(bbox.height() / std::abs(first.cellSize.y)));
+    return meta;
+}
+
+RasterMosaic::RasterMosaic(std::vector<MosaicTile> tiles, GeoMetadata metadata)
+: _tiles(std::move(tiles))
+, _metadata(std::move(metadata))
+{
+}
+
+RasterMosaic RasterMosaic::create(std::span<const fs::path> tilePaths, uint32_t threadCount)
+{
+    std::vector<MosaicTile> tiles(tilePaths.size());
+    parallel_for(int64_t(tilePaths.size()), threadCount, [&](int64_t index) {
+        tiles[index].path     = tilePaths[index];
+        tiles[index].metadata = io::read_metadata(tilePaths[index]);
+    });
+
+    return create(std::move(tiles));
+}
+
+RasterMosaic RasterMosaic::create(std::vector<MosaicTile> tiles)
+{
+    auto meta = mosaic_metadata(tiles);
+    RasterMosaic mosaic(std::move(tiles), std::move(meta));
+    mosaic.build_index();
+    return mosaic;
+}
+
+void RasterMosaic::build_index()
+{
+    _nodes.clear();
+    _entries.resize(_tiles.size());
+    std::iota(_entries.begin(), _entries.end(), 0);
+
+    str_sort(_entries, s_nodeCapacity, [this](uint32_t index) {
+        return _tiles[index].metadata.bounding_box();
+    });
+
+    std::vector<IndexNode> level;
+    for (size_t begin = 0; begin < _entries.size(); begin += s_nodeCapacity) {
+        IndexNode node;
+        node.leaf  = true;
+        node.begin = truncate<uint32_t>(begin);
+        node.end   = truncate<uint32_t>(std::min(_entries.size(), begin + s_nodeCapacity));
+        node.bbox  = _tiles[_entries[begin]].metadata.bounding_box();
+        for (auto i = node.begin; i < node.end; ++i) {
+            node.bbox = united(node.bbox, _tiles[_entries[i]].metadata.bounding_box());
+        }
+
+        level.push_back(node);
+    }
+
+    // pack every level into parent nodes until only the root remains, the root ends up as the last node
+    while (true) {
+        str_sort(level, s_nodeCapacity, [](const IndexNode& node) {
+            return node.bbox;
+        });
+
+        const auto levelOffset = _nodes.size();
+        _nodes.insert(_nodes.end(), level.begin(), level.end());
+        if (level.size() == 1) {
+            break;
+        }
+
+        std::vector<IndexNode> parents;
+        for (size_t begin = 0; begin < level.size(); begin += s_nodeCapacity) {
+            IndexNode node;
+            node.begin = truncate<uint32_t>(levelOffset + begin);
+            node.end   = truncate<uint32_t>(levelOffset + std::min(level.size(), begin + s_nodeCapacity));
+            node.bbox  = _nodes[node.begin].bbox;
+            for (auto i = node.begin; i < node.end; ++i) {
+                node.bbox = united(node.bbox, _nodes[i].bbox);
+            }
+
+            parents.push_back(node);
+        }
+
+        level = std::move(parents);
+    }
+}
+
+std::span<const MosaicTile> RasterMosaic::tiles() const noexcept
+{
+    return _tiles;
+}
+
+const GeoMetadata& RasterMosaic::metadata() const noexcept
+{
+    return _metadata;
+}
+
+std::vector<size_t> RasterMosaic::intersecting_tiles(const Rect<double>& extent) const
+{
+    std::vector<size_t> result;
+    if (_nodes.empty()) {
+        return result;
+    }
+
+    std::vector<uint32_t> stack = {truncate<uint32_t>(_nodes.size() - 1)};
+    while (!stack.empty()) {
+        auto& node = _nodes[stack.back()];
+        stack.pop_back();
+
+        if (!rectangles_intersect(node.bbox, extent)) {
+            continue;
+        }
+
+        for (auto i = node.begin; i < node.end; ++i) {
+            if (!node.leaf) {
+                stack.push_back(i);
+            } else if (rectangles_intersect(_tiles[_entries[i]].metadata.bounding_box(), extent)) {
+                result.push_back(_entries[i]);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<RasterMosaic::TileCutOut> RasterMosaic::intersecting_cutouts(const GeoMetadata& extent, bool& covered) const
+{
+    std::vector<TileCutOut> result;
+
+    int64_t coveredCells = 0;
+    for (auto tileIndex : intersecting_tiles(extent.bounding_box())) {
+        auto cutOut = io::detail::intersect_metadata(_tiles[tileIndex].metadata, extent);
+        if (cutOut.rows > 0 && cutOut.cols > 0) {
+            coveredCells += int64_t(cutOut.rows) * cutOut.cols;
+            result.push_back(TileCutOut{tileIndex, cutOut});
+        }
+    }
+
+    // the extent is covered when the cut outs do not overlap and together contain all the cells of the extent
+    covered = coveredCells == int64_t(extent.rows) * extent.cols;
+    for (size_t i = 0; covered && i < result.size(); ++i) {
+        for (size_t j = i + 1; covered && j < result.size(); ++j) {
+            auto& lhs = result[i].cutOut;
+            auto& rhs = result[j].cutOut;
+            covered   = lhs.dstColOffset >= rhs.dstColOffset + rhs.cols || rhs.dstColOffset >= lhs.dstColOffset + lhs.cols ||
+                      lhs.dstRowOffset >= rhs.dstRowOffset + rhs.rows || rhs.dstRowOffset >= lhs.dstRowOffset + lhs.rows;
+        }
+    }
+
+    return result;
+}
+
+std::optional<double> RasterMosaic::tile_nodata(const RasterDataSet& tile, int bandNr, const std::type_info& dataType)
+{
+    auto nodata = tile.nodata_value(bandNr);
+    if (!nodata.has_value()) {
+        return nodata;
+    }
+
+    // convert the nodata to the band type and from the band type to the data type, gdal converts the cells the same way when reading
+    const auto bandType = resolve_type(tile.band_datatype(bandNr));
+    const auto readType = resolve_type(dataType);
+
+    double bandValue[2] = {0.0, 0.0}; // large enough for every data type, including the complex types
+    double readValue[2] = {0.0, 0.0};
+    double result       = 0.0;
+    GDALCopyWords(&(*nodata), GDT_Float64, 0, bandValue, bandType, 0, 1);
+    GDALCopyWords(bandValue, bandType, 0, readValue, readType, 0, 1);
+    GDALCopyWords(readValue, readType, 0, &result, GDT_Float64, 0, 1);
+    return result;
+}
+
+static std::string nodata_to_string(std::optional<double> nodata)
+{
+    return nodata.has_value() ? fmt::format("{}", *nodata) : std::string("none");
+}
+
+static std::optional<double> nodata_from_string(std::string_view str)
+{
+    if (str == "none") {
+        return {};
+    }
+
+    return str::to_double_value(str);
+}
+
+void RasterMosaic::save(const fs::path& indexPath) const
+{
+    std::string contents;
+    contents += fmt::format("{}\t{}\n", s_indexHeader, s_indexVersion);
+    contents += fmt::format("projection\t{}\n", _metadata.projection);
+
+    for (auto& tile : _tiles) {
+        auto& meta = tile.metadata;
+        contents += fmt::format("tile\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\n", meta.rows, meta.cols, meta.xll, meta.yll, meta.cellSize.x, meta.cellSize.y, nodata_to_string(meta.nodata), file::generic_u8string(tile.path));
+    }
+
+    for (auto& node : _nodes) {
+        contents += fmt::format("node\t{}\t{}\t{}\t{}\t{}\t{}\t{}\n", node.bbox.topLeft.x, node.bbox.topLeft.y, node.bbox.bottomRight.x, node.bbox.bottomRight.y, node.begin, node.end, node.leaf ? 1 : 0);
+    }
+
+    std::vector<std::string> entries;
+    for (auto entry : _entries) {
+        entries.push_back(std::to_string(entry));
+    }
+
+    contents += fmt::format("entries\t{}\n", str::join(entries, "\t"));
+    file::write_as_text(indexPath, contents);
+}
+
+RasterMosaic RasterMosaic::load(const fs::path& indexPath)
+{
+    auto contents = file::read_as_text(indexPath);
+    auto lines    = str::split_view(contents, '\n');
+    if (lines.empty() || lines.front() != fmt::format("{}\t{}", s_indexHeader, s_indexVersion)) {
+        throw RuntimeError("Invalid raster mosaic index: {}", indexPath);
+    }
+
+    std::string projection;
+    std::vector<MosaicTile> tiles;
+    std::vector<IndexNode> nodes;
+    std::vector<uint32_t> entries;
+
+    for (size_t lineNr = 1; lineNr < lines.size(); ++lineNr) {
+        auto line = str::trimmed_view(lines[lineNr]);
+        if (line.empty()) {
+            continue;
+        }
+
+        auto fields = str::split_view(line, '\t');
+        if (fields.front() == "projection"sv) {
+            projection = line.substr(std::min(line.size(), fields.front().size() + 1));
+        } else if (fields.front() == "tile"sv && fields.size() == 9) {
+            MosaicTile tile;
+            tile.metadata.rows       = str::to_int32_value(fields[1]);
+            tile.metadata.cols       = str::to_int32_value(fields[2]);
+            tile.metadata.xll        = str::to_double_value(fields[3]);
+            tile.metadata.yll        = str::to_double_value(fields[4]);
+            tile.metadata.cellSize   = GeoMetadata::CellSize(str::to_double_value(fields[5]), str::to_double_value(fields[6]));
+            tile.metadata.nodata     = nodata_from_string(fields[7]);
+            tile.metadata.projection = projection;
+            tile.path                = file::u8path(fields[8]);
+            tiles.push_back(std::move(tile));
+        } else if (fields.front() == "node"sv && fields.size() == 8) {
+            IndexNode node;
+            node.bbox.topLeft     = Point<double>(str::to_double_value(fields[1]), str::to_double_value(fields[2]));
+            node.bbox.bottomRight = Point<double>(str::to_double_value(fields[3]), str::to_double_value(fields[4]));
+            node.begin            = str::to_uint32_value(fields[5]);
+            node.end              = str::to_uint32_value(fields[6]);
+            node.leaf             = fields[7] == "1"sv;
+            nodes.push_back(node);
+        } else if (fields.front() == "entries"sv) {
+            for (size_t i = 1; i < fields.size(); ++i) {
+                entries.push_back(str::to_uint32_value(fields[i]));
+            }
+        } else {
+            throw RuntimeError("Invalid raster mosaic index line {}: {}", lineNr + 1, line);
+        }
+    }
+
+    if (entries.size() != tiles.size()) {
+        throw RuntimeError("Invalid raster mosaic index: {} (entry count does not match the tile count)", indexPath);
+    }
+
+    for (auto& node : nodes) {
+        const auto limit = node.leaf ? entries.size() : nodes.size();
+        if (node.begin > node.end || node.end > limit) {
+            throw RuntimeError("Invalid raster mosaic index: {} (invalid node range)", indexPath);
+        }
+    }
+
+    for (auto entry : entries) {
+        if (entry >= tiles.size()) {
+            throw RuntimeError("Invalid raster mosaic index: {} (invalid tile index)", indexPath);
+        }
+    }
+
+    auto meta = mosaic_metadata(tiles);
+    RasterMosaic mosaic(std::move(tiles), std::move(meta));
+    mosaic._nodes   = std::move(nodes);
+    mosaic._entries = std::move(entries);
+    return mosaic;
+}
+
+}
@@ -0,0 +1,348 @@
+#include "infra/gdalrasterizer.h"
+#include "infra/cast.h"
+#include "infra/exception.h"
+#include "infra/point.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace inf::gdal {
+
+namespace {
+
+// A polygon ring in pixel coordinates of the window (x: column, y: row counted from the top)
+struct Ring
+{
+    std::vector<Point<double>> points;
+    bool hole = false;
+};
+
+struct Edge
+{
+    double yMin    = 0.0;
+    double yMax    = 0.0;
+    double xAtYMin = 0.0;
+    double xAtYMax = 0.0;
+};
+
+void add_ring(LinearRingCRef ring, const GeoMetadata& meta, bool hole, std::vector<Ring>& rings)
+{
+    const auto topLeft    = meta.top_left();
+    const auto cellHeight = std::abs(meta.cellSize.y);
+
+    Ring result;
+    result.hole = hole;
+    result.points.reserve(ring.point_count() + 1);
+    for (int i = 0; i < ring.point_count(); ++i) {
+        const auto point = ring.point_at(i);
+        result.points.emplace_back((point.x - topLeft.x) / meta.cellSize.x, (topLeft.y - point.y) / cellHeight);
+    }
+
+    if (result.points.size() < 3) {
+        return;
+    }
+
+    if (result.points.front() != result.points.back()) {
+        result.points.push_back(result.points.front());
+    }
+
+    rings.push_back(std::move(result));
+}
+
+void add_polygon(PolygonCRef polygon, const GeoMetadata& meta, std::vector<Ring>& rings)
+{
+    if (polygon.get()->IsEmpty()) {
+        return;
+    }
+
+    add_ring(polygon.exterior_ring(), meta, false, rings);
+    for (int i = 0; i < polygon.interior_ring_count(); ++i) {
+        add_ring(polygon.interior_ring(i), meta, true, rings);
+    }
+}
+
+std::vector<Ring> polygon_rings(PolygonCRef polygon, const GeoMetadata& meta)
+{
+    std::vector<Ring> rings;
+    add_polygon(polygon, meta, rings);
+    return rings;
+}
+
+std::vector<Ring> polygon_rings(MultiPolygonCRef multiPolygon, const GeoMetadata& meta)
+{
+    std::vector<Ring> rings;
+    for (int i = 0; i < multiPolygon.size(); ++i) {
+        add_polygon(multiPolygon.polygon_at(i), meta, rings);
+    }
+
+    return rings;
+}
+
+// Invokes the callback with the column range [beginCol, endCol) of every run of cells of which the centre is inside the rings (even-odd rule)
+// The intersections and the rounding match GDALRasterize: a centre that lies exactly on a left edge is outside, on a right edge it is inside
+template <typename Callback>
+void scanline_spans(const std::vector<Ring>& rings, int32_t rows, int32_t cols, Callback&& cb)
+{
+    std::vector<Edge> edges;
+    for (auto& ring : rings) {
+        for (size_t i = 0; i + 1 < ring.points.size(); ++i) {
+            const auto& p0 = ring.points[i];
+            const auto& p1 = ring.points[i + 1];
+            if (p0.y == p1.y) {
+                continue;
+            }
+
+            const auto& top    = p0.y < p1.y ? p0 : p1;
+            const auto& bottom = p0.y < p1.y ? p1 : p0;
+            edges.push_back(Edge{top.y, bottom.y, top.x, bottom.x});
+        }
+    }
+
+    std::sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) { return lhs.yMin < rhs.yMin; });
+
+    // active edge list: the edges that cross the centre line of the current row, an edge covers the half open range [yMin, yMax)
+    std::vector<const Edge*> activeEdges;
+    std::vector<double> intersections;
+    size_t nextEdge = 0;
+
+    for (int32_t row = 0; row < rows; ++row) {
+        const auto y = row + 0.5;
+
+        while (nextEdge < edges.size() && edges[nextEdge].yMin <= y) {
+            activeEdges.push_back(&edges[nextEdge++]);
+        }
+
+        std::erase_if(activeEdges, [y](const Edge* edge) { return edge->yMax <= y; });
+        if (activeEdges.empty()) {
+            if (nextEdge == edges.size()) {
+                break;
+            }
+
+            continue;
+        }
+
+        intersections.clear();
+        for (auto* edge : activeEdges) {
+            intersections.push_back((y - edge->yMin) * (edge->xAtYMax - edge->xAtYMin) / (edge->yMax - edge->yMin) + edge->xAtYMin);
+        }
+
+        std::sort(intersections.begin(), intersections.end());
+        for (size_t i = 0; i + 1 < intersections.size(); i += 2) {
+            // the cells with a centre in (x0, x1]
+            const auto beginCol = int32_t(std::clamp(std::floor(intersections[i] + 0.5), 0.0, double(cols)));
+            const auto endCol   = int32_t(std::clamp(std::floor(intersections[i + 1] + 0.5), 0.0, double(cols)));
+            if (beginCol < endCol) {
+                cb(row, beginCol, endCol);
+            }
+        }
+    }
+}
+
+// Accumulates the signed area contribution of a line segment to the cells it crosses, the coverage of a cell
+// is the running sum of the accumulated values of the row up to that cell. The accumulation buffer has cols + 2 values per row.
+// The segment has to lie within 0 <= x <= cols.
+void accumulate_segment(Point<double> p0, Point<double> p1, double sign, int32_t rows, int32_t cols, std::vector<double>& acc)
+{
+    if (p0.y == p1.y) {
+        return;
+    }
+
+    double dir = sign;
+    if (p0.y > p1.y) {
+        std::swap(p0, p1);
+        dir = -dir;
+    }
+
+    const auto rowStride = size_t(cols) + 2;
+    const auto dxdy      = (p1.x - p0.x) / (p1.y - p0.y);
+
+    // keep x within the window to avoid rounding errors accumulating outside of the buffer
+    const auto maxX = double(cols);
+    double x        = p0.x;
+    if (p0.y < 0.0) {
+        x -= p0.y * dxdy;
+    }
+
+    x = std::clamp(x, 0.0, maxX);
+
+    const auto firstRow = std::max(0, int32_t(std::floor(p0.y)));
+    const auto endRow   = std::min(rows, int32_t(std::ceil(p1.y)));
+    for (int32_t row = firstRow; row < endRow; ++row) {
+        auto* line = acc.data() + size_t(row) * rowStride;
+
+        const auto dy    = std::min(row + 1.0, p1.y) - std::max(double(row), p0.y);
+        const auto xNext = std::clamp(x + dxdy * dy, 0.0, maxX);
+        const auto d     = dy * dir;
+
+        const auto x0 = std::min(x, xNext);
+        const auto x1 = std::max(x, xNext);
+
+        const auto x0Floor = std::floor(x0);
+        const auto x0i     = int32_t(x0Floor);
+        const auto x1Ceil  = std::ceil(x1);
+        const auto x1i     = int32_t(x1Ceil);
+
+        if (x1i <= x0i + 1) {
+            // the segment stays within a single cell of the row
+            const auto xmf = 0.5 * (x + xNext) - x0Floor;
+            line[x0i] += d - d * xmf;
+            line[x0i + 1] += d * xmf;
+        } else {
+            const auto s   = 1.0 / (x1 - x0);
+            const auto x0f = x0 - x0Floor;
+            const auto a0  = 0.5 * s * (1.0 - x0f) * (1.0 - x0f);
+            const auto x1f = x1 - x1Ceil + 1.0;
+            const auto am  = 0.5 * s * x1f * x1f;
+
+            line[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                line[x0i + 1] += d * (1.0 - a0 - am);
+            } else {
+                const auto a1 = s * (1.5 - x0f);
+                line[x0i + 1] += d * (a1 - a0);
+                for (int32_t xi = x0i + 2; xi < x1i - 1; ++xi) {
+                    line[xi] += d * s;
+                }
+
+                const auto a2 = a1 + (x1i - x0i - 3) * s;
+                line[x1i - 1] += d * (1.0 - a2 - am);
+            }
+
+            line[x1i] += d * am;
+        }
+
+        x = xNext;
+    }
+}
+
+double signed_area(const Ring& ring) noexcept
+{
+    double area = 0.0;
+    for (size_t i = 0; i + 1 < ring.points.size(); ++i) {
+        area += ring.points[i].x * ring.points[i + 1].y - ring.points[i + 1].x * ring.points[i].y;
+    }
+
+    return area / 2.0;
+}
+
+void ring_coverage(const std::vector<Ring>& rings, int32_t rows, int32_t cols, std::span<float> coverage)
+{
+    std::vector<double> acc((size_t(cols) + 2) * size_t(rows), 0.0);
+
+    for (auto& ring : rings) {
+        // exterior rings and holes need an opposite orientation for the holes to be subtracted
+        const auto area = signed_area(ring);
+        if (area == 0.0) {
+            continue;
+        }
+
+        const auto sign = ((area > 0.0) != ring.hole) ? 1.0 : -1.0;
+
+        for (size_t i = 0; i + 1 < ring.points.size(); ++i) {
+            auto p0 = ring.points[i];
+            auto p1 = ring.points[i + 1];
+
+            // split the segment at the left and right edge of the window, the parts outside of the window
+            // are moved onto the window edge: left of the window they cover the full row, right of the window nothing
+            std::array<double, 4> splits{0.0, 0.0, 0.0, 1.0};
+            size_t splitCount = 1;
+            if (p0.x != p1.x) {
+                for (double edgeX : {0.0, double(cols)}) {
+                    const auto t = (edgeX - p0.x) / (p1.x - p0.x);
+                    if (t > 0.0 && t < 1.0) {
+                        splits[splitCount++] = t;
+                    }
+                }
+            }
+
+            if (splitCount == 3 && splits[1] > splits[2]) {
+                std::swap(splits[1], splits[2]);
+            }
+
+            splits[splitCount++] = 1.0;
+
+            auto clampPoint = [&](double t) {
+                return Point<double>(std::clamp(p0.x + t * (p1.x - p0.x), 0.0, double(cols)), p0.y + t * (p1.y - p0.y));
+            };
+
+            for (size_t split = 0; split + 1 < splitCount; ++split) {
+                accumulate_segment(clampPoint(splits[split]), clampPoint(splits[split + 1]), sign, rows, cols, acc);
+            }
+        }
+    }
+
+    for (int32_t row = 0; row < rows; ++row) {
+        const auto* line = acc.data() + size_t(row) * (size_t(cols) + 2);
+        auto* dstLine    = coverage.data() + size_t(row) * cols;
+
+        double sum = 0.0;
+        for (int32_t col = 0; col < cols; ++col) {
+            sum += line[col];
+            dstLine[col] = float(std::clamp(std::abs(sum), 0.0, 1.0));
+        }
+    }
+}
+
+template <typename T>
+void burn_rings(const std::vector<Ring>& rings, const GeoMetadata& meta, T burnValue, std::span<T> data)
+{
+    if (truncate<int32_t>(data.size()) != meta.rows * meta.cols) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    scanline_spans(rings, meta.rows, meta.cols, [&](int32_t row, int32_t beginCol, int32_t endCol) {
+        auto* rowData = data.data() + size_t(row) * meta.cols;
+        std::fill(rowData + beginCol, rowData + endCol, burnValue);
+    });
+}
+
+void coverage_rings(const std::vector<Ring>& rings, const GeoMetadata& meta, std::span<float> coverage)
+{
+    if (truncate<int32_t>(coverage.size()) != meta.rows * meta.cols) {
+        throw InvalidArgument("Invalid coverage buffer provided: incorrect size");
+    }
+
+    ring_coverage(rings, meta.rows, meta.cols, coverage);
+}
+
+}
+
+template <typename T>
+void burn_polygon(PolygonCRef polygon, const GeoMetadata& meta, T burnValue, std::span<T> data)
+{
+    burn_rings(polygon_rings(polygon, meta), meta, burnValue, data);
+}
+
+template <typename T>
+void burn_polygon(MultiPolygonCRef polygon, const GeoMetadata& meta, T burnValue, std::span<T> data)
+{
+    burn_rings(polygon_rings(polygon, meta), meta, burnValue, data);
+}
+
+void polygon_coverage(PolygonCRef polygon, const GeoMetadata& meta, std::span<float> coverage)
+{
+    coverage_rings(polygon_rings(polygon, meta), meta, coverage);
+}
+
+void polygon_coverage(MultiPolygonCRef polygon, const GeoMetadata& meta, std::span<float> coverage)
+{
+    coverage_rings(polygon_rings(polygon, meta), meta, coverage);
+}
+
+template void burn_polygon<float>(PolygonCRef polygon, const GeoMetadata& meta, float burnValue, std::span<float> data);
+template void burn_polygon<double>(PolygonCRef polygon, const GeoMetadata& meta, double burnValue, std::span<double> data);
+template void burn_polygon<int32_t>(PolygonCRef polygon, const GeoMetadata& meta, int32_t burnValue, std::span<int32_t> data);
+template void burn_polygon<int16_t>(PolygonCRef polygon, const GeoMetadata& meta, int16_t burnValue, std::span<int16_t> data);
+template void burn_polygon<uint16_t>(PolygonCRef polygon, const GeoMetadata& meta, uint16_t burnValue, std::span<uint16_t> data);
+template void burn_polygon<uint8_t>(PolygonCRef polygon, const GeoMetadata& meta, uint8_t burnValue, std::span<uint8_t> data);
+
+template void burn_polygon<float>(MultiPolygonCRef polygon, const GeoMetadata& meta, float burnValue, std::span<float> data);
+template void burn_polygon<double>(MultiPolygonCRef polygon, const GeoMetadata& meta, double burnValue, std::span<double> data);
+template void burn_polygon<int32_t>(MultiPolygonCRef polygon, const GeoMetadata& meta, int32_t burnValue, std::span<int32_t> data);
+template void burn_polygon<int16_t>(MultiPolygonCRef polygon, const GeoMetadata& meta, int16_t burnValue, std::span<int16_t> data);
+template void burn_polygon<uint16_t>(MultiPolygonCRef polygon, const GeoMetadata& meta, uint16_t burnValue, std::span<uint16_t> data);
+template void burn_polygon<uint8_t>(MultiPolygonCRef polygon, const GeoMetadata& meta, uint8_t burnValue, std::span<uint8_t> data);
+
+}
@@ -0,0 +1,136 @@
+#include "infra/gdalstatistics.h"
+#include "infra/cast.h"
+#include "infra/gdal.h"
+#include "infra/gdalio.h"
+#include "infra/parallelfor.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace inf::gdal {
+
+namespace {
+
+// The part of the band that is processed, maskCols is the row stride of the mask
+struct StatisticsWindow
+{
+    int32_t srcColOffset  = 0;
+    int32_t srcRowOffset  = 0;
+    int32_t cols          = 0;
+    int32_t rows          = 0;
+    int32_t maskColOffset = 0;
+    int32_t maskRowOffset = 0;
+    int32_t maskCols      = 0;
+};
+
+// Target number of cells in a strip, rounded up to the block height of the band
+constexpr int64_t s_stripCells = 1024 * 1024;
+
+// The strips are read as T, which has to represent the band values exactly so the nodata is compared in the band type
+template <typename T>
+RasterStatistics compute_window_statistics(RasterDataSet& dataSet, const fs::path& filePath, int bandNr, const StatisticsWindow& window, std::span<const uint8_t> mask, const StatisticsOptions& options)
+{
+    const auto nodata    = dataSet.nodata_value(bandNr);
+    const auto blockRows = std::max(1, dataSet.rasterband(bandNr).block_size().height);
+    auto stripRows       = std::max(blockRows, truncate<int32_t>(s_stripCells / window.cols));
+    stripRows            = ((stripRows + blockRows - 1) / blockRows) * blockRows;
+
+    // strip boundaries are multiples of the strip size in raster row space
+    const auto endRow = window.srcRowOffset + window.rows;
+    std::vector<std::pair<int32_t, int32_t>> strips; // first row, row count
+    for (auto row = window.srcRowOffset; row < endRow;) {
+        auto stripEnd = std::min(endRow, (row / stripRows + 1) * stripRows);
+        strips.emplace_back(row, stripEnd - row);
+        row = stripEnd;
+    }
+
+    struct ThreadState
+    {
+        RasterDataSet dataSet;
+        std::vector<T> data;
+        std::vector<uint8_t> mask;
+    };
+
+    // every strip gets its own accumulator, merging them in order makes the result independent of the scheduling
+    std::vector<StatisticsAccumulator> stripStats(strips.size(), StatisticsAccumulator(options));
+    parallel_for(
+        truncate<int64_t>(strips.size()), options.threadCount,
+        [&]() { return ThreadState{RasterDataSet::open(filePath), {}, {}}; },
+        [&](ThreadState& state, int64_t index) {
+            auto [firstRow, rows] = strips[index];
+            const auto cells      = size_t(rows) * window.cols;
+
+            state.data.resize(cells);
+            state.dataSet.read_rasterdata<T>(bandNr, window.srcColOffset, firstRow, window.cols, rows, state.data.data(), window.cols, rows);
+
+            std::span<const uint8_t> stripMask;
+            if (!mask.empty()) {
+                state.mask.resize(cells);
+                for (int32_t row = 0; row < rows; ++row) {
+                    const auto maskRow = window.maskRowOffset + (firstRow - window.srcRowOffset) + row;
+                    auto maskData      = mask.subspan(size_t(maskRow) * window.maskCols + window.maskColOffset, window.cols);
+                    std::copy(maskData.begin(), maskData.end(), state.mask.begin() + size_t(row) * window.cols);
+                }
+
+                stripMask = state.mask;
+            }
+
+            stripStats[index].add(std::span<const T>(state.data), nodata, stripMask);
+        });
+
+    StatisticsAccumulator result(options);
+    for (auto& stats : stripStats) {
+        result.merge(stats);
+    }
+
+    return result.result();
+}
+
+RasterStatistics compute_window_statistics(const fs::path& filePath, int bandNr, const StatisticsWindow& window, std::span<const uint8_t> mask, const StatisticsOptions& options)
+{
+    if (window.rows <= 0 || window.cols <= 0) {
+        return StatisticsAccumulator(options).result();
+    }
+
+    // float bands are read as float, a nodata value that is not representable as float has to be compared as float (e.g. 0.1)
+    auto dataSet = RasterDataSet::open(filePath);
+    if (dataSet.band_datatype(bandNr) == typeid(float)) {
+        return compute_window_statistics<float>(dataSet, filePath, bandNr, window, mask, options);
+    }
+
+    return compute_window_statistics<double>(dataSet, filePath, bandNr, window, mask, options);
+}
+
+}
+
+RasterStatistics compute_statistics(const fs::path& filePath, int bandNr, const StatisticsOptions& options)
+{
+    auto dataSet = RasterDataSet::open(filePath);
+
+    StatisticsWindow window;
+    window.cols = dataSet.x_size();
+    window.rows = dataSet.y_size();
+    return compute_window_statistics(filePath, bandNr, window, {}, options);
+}
+
+RasterStatistics compute_statistics(const fs::path& filePath, int bandNr, const GeoMetadata& extent, std::span<const uint8_t> mask, const StatisticsOptions& options)
+{
+    if (!mask.empty() && mask.size() != size_t(extent.rows) * size_t(extent.cols)) {
+        throw InvalidArgument("Mask size does not match the extent ({} <-> {}x{})", mask.size(), extent.rows, extent.cols);
+    }
+
+    auto meta   = RasterDataSet::open(filePath).geometadata(bandNr);
+    auto cutOut = io::detail::intersect_metadata(meta, extent);
+
+    StatisticsWindow window;
+    window.srcColOffset  = std::max(0, cutOut.srcColOffset);
+    window.srcRowOffset  = std::max(0, cutOut.srcRowOffset);
+    window.cols          = cutOut.cols;
+    window.rows          = cutOut.rows;
+    window.maskColOffset = cutOut.dstColOffset;
+    window.maskRowOffset = cutOut.dstRowOffset;
+    window.maskCols      = extent.cols;
+    return compute_window_statistics(filePath, bandNr, window, mask, options);
+}
+
+}
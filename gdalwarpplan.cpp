@@ -0,0 +1,210 @@
+#include "infra/gdalwarpplan.h"
+#include "infra/gdal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <gdal_alg.h>
+
+namespace inf::gdal {
+
+namespace {
+
+// Transforms destination pixel/line coordinates to source pixel/line coordinates
+class PixelTransformer
+{
+public:
+    PixelTransformer(const GeoMetadata& srcMeta, const GeoMetadata& dstMeta)
+    {
+        auto memDriver = RasterDriver::create(RasterType::Memory);
+        _srcDataSet    = memDriver.create_dataset<uint8_t>(srcMeta.rows, srcMeta.cols, 0);
+        _dstDataSet    = memDriver.create_dataset<uint8_t>(dstMeta.rows, dstMeta.cols, 0);
+        _srcDataSet.write_geometadata(srcMeta);
+        _dstDataSet.write_geometadata(dstMeta);
+
+        _transformerArg = check_pointer(GDALCreateGenImgProjTransformer(_srcDataSet.get(), nullptr, _dstDataSet.get(), nullptr, FALSE, 0.0, 0),
+                                        "Failed to create warp plan transformer");
+    }
+
+    PixelTransformer(const PixelTransformer&)            = delete;
+    PixelTransformer& operator=(const PixelTransformer&) = delete;
+
+    ~PixelTransformer() noexcept
+    {
+        GDALDestroyGenImgProjTransformer(_transformerArg);
+    }
+
+    // Transforms the points in place, success is set to false for the points that could not be transformed
+    void transform(std::vector<double>& x, std::vector<double>& y, std::vector<int>& success)
+    {
+        std::vector<double> z(x.size(), 0.0);
+        success.assign(x.size(), FALSE);
+        GDALGenImgProjTransform(_transformerArg, TRUE, truncate<int>(x.size()), x.data(), y.data(), z.data(), success.data());
+    }
+
+private:
+    RasterDataSet _srcDataSet;
+    RasterDataSet _dstDataSet;
+    void* _transformerArg = nullptr;
+};
+
+}
+
+WarpPlan::WarpPlan(const GeoMetadata& srcMeta, const GeoMetadata& dstMeta, ResampleAlgorithm algo)
+: _srcMeta(srcMeta)
+, _dstMeta(dstMeta)
+, _algo(algo)
+{
+    if (srcMeta.projection.empty()) {
+        throw RuntimeError("Warp plan source does not contain projection information");
+    }
+
+    if (dstMeta.projection.empty()) {
+        throw RuntimeError("Warp plan destination does not contain projection information");
+    }
+
+    if (algo != ResampleAlgorithm::NearestNeighbour && algo != ResampleAlgorithm::Bilinear && algo != ResampleAlgorithm::Average) {
+        throw InvalidArgument("Unsupported warp plan resample algorithm: {}", resample_algo_to_string(algo));
+    }
+
+    if (uint64_t(srcMeta.rows) * uint64_t(srcMeta.cols) >= s_noSource) {
+        throw InvalidArgument("Warp plan source raster is too large ({}x{})", srcMeta.rows, srcMeta.cols);
+    }
+
+    const auto srcRows = srcMeta.rows;
+    const auto srcCols = srcMeta.cols;
+    const auto dstRows = dstMeta.rows;
+    const auto dstCols = dstMeta.cols;
+
+    PixelTransformer transformer(srcMeta, dstMeta);
+    std::vector<double> x, y;
+    std::vector<int> success;
+
+    if (algo != ResampleAlgorithm::Average) {
+        // sample the source at the cell centres of the destination
+        if (algo == ResampleAlgorithm::NearestNeighbour) {
+            _indexes.reserve(size_t(dstRows) * dstCols);
+        } else {
+            _offsets.reserve(size_t(dstRows) * dstCols + 1);
+            _offsets.push_back(0);
+        }
+
+        for (int32_t row = 0; row < dstRows; ++row) {
+            x.resize(dstCols);
+            y.assign(dstCols, row + 0.5);
+            for (int32_t col = 0; col < dstCols; ++col) {
+                x[col] = col + 0.5;
+            }
+
+            transformer.transform(x, y, success);
+
+            for (int32_t col = 0; col < dstCols; ++col) {
+                const bool onMap = success[col] && x[col] >= 0.0 && y[col] >= 0.0 && x[col] <= srcCols && y[col] <= srcRows;
+
+                if (algo == ResampleAlgorithm::NearestNeighbour) {
+                    // same cell selection as the gdal warp kernel
+                    const auto srcCol = int32_t(std::floor(x[col] + 1e-10));
+                    const auto srcRow = int32_t(std::floor(y[col] + 1e-10));
+                    if (onMap && srcCol < srcCols && srcRow < srcRows) {
+                        _indexes.push_back(uint32_t(srcRow) * uint32_t(srcCols) + uint32_t(srcCol));
+                    } else {
+                        _indexes.push_back(s_noSource);
+                    }
+
+                    continue;
+                }
+
+                if (onMap) {
+                    // the 2x2 source cells around the sample point, cells outside of the source are skipped
+                    const auto fx     = x[col] - 0.5;
+                    const auto fy     = y[col] - 0.5;
+                    const auto leftX  = int32_t(std::floor(fx));
+                    const auto topY   = int32_t(std::floor(fy));
+                    const auto deltaX = fx - leftX;
+                    const auto deltaY = fy - topY;
+
+                    for (int32_t dy = 0; dy < 2; ++dy) {
+                        for (int32_t dx = 0; dx < 2; ++dx) {
+                            const auto srcCol = leftX + dx;
+                            const auto srcRow = topY + dy;
+                            const auto weight = (dx == 0 ? 1.0 - deltaX : deltaX) * (dy == 0 ? 1.0 - deltaY : deltaY);
+                            if (weight > 0.0 && srcCol >= 0 && srcRow >= 0 && srcCol < srcCols && srcRow < srcRows) {
+                                _indexes.push_back(uint32_t(srcRow) * uint32_t(srcCols) + uint32_t(srcCol));
+                                _weights.push_back(float(weight));
+                            }
+                        }
+                    }
+                }
+
+                _offsets.push_back(_indexes.size());
+            }
+        }
+
+        return;
+    }
+
+    // average: the source cells that overlap with the footprint of a destination cell, weighted by the overlapping area
+    // the footprint is the bounding box of the transformed corners of the destination cell
+    std::vector<double> topX, topY, bottomX, bottomY;
+    std::vector<int> topSuccess, bottomSuccess;
+
+    auto transformCorners = [&](int32_t row, std::vector<double>& cx, std::vector<double>& cy, std::vector<int>& cs) {
+        cx.resize(dstCols + 1);
+        cy.assign(dstCols + 1, double(row));
+        for (int32_t col = 0; col <= dstCols; ++col) {
+            cx[col] = col;
+        }
+
+        transformer.transform(cx, cy, cs);
+    };
+
+    _offsets.reserve(size_t(dstRows) * dstCols + 1);
+    _offsets.push_back(0);
+
+    transformCorners(0, topX, topY, topSuccess);
+    for (int32_t row = 0; row < dstRows; ++row) {
+        transformCorners(row + 1, bottomX, bottomY, bottomSuccess);
+
+        for (int32_t col = 0; col < dstCols; ++col) {
+            if (topSuccess[col] && topSuccess[col + 1] && bottomSuccess[col] && bottomSuccess[col + 1]) {
+                const auto minX = std::max(0.0, std::min({topX[col], topX[col + 1], bottomX[col], bottomX[col + 1]}));
+                const auto maxX = std::min(double(srcCols), std::max({topX[col], topX[col + 1], bottomX[col], bottomX[col + 1]}));
+                const auto minY = std::max(0.0, std::min({topY[col], topY[col + 1], bottomY[col], bottomY[col + 1]}));
+                const auto maxY = std::min(double(srcRows), std::max({topY[col], topY[col + 1], bottomY[col], bottomY[col + 1]}));
+
+                for (auto srcRow = int32_t(std::floor(minY)); srcRow < maxY; ++srcRow) {
+                    const auto height = std::min(srcRow + 1.0, maxY) - std::max(double(srcRow), minY);
+                    for (auto srcCol = int32_t(std::floor(minX)); srcCol < maxX; ++srcCol) {
+                        const auto width = std::min(srcCol + 1.0, maxX) - std::max(double(srcCol), minX);
+                        if (width > 0.0 && height > 0.0) {
+                            _indexes.push_back(uint32_t(srcRow) * uint32_t(srcCols) + uint32_t(srcCol));
+                            _weights.push_back(float(width * height));
+                        }
+                    }
+                }
+            }
+
+            _offsets.push_back(_indexes.size());
+        }
+
+        std::swap(topX, bottomX);
+        std::swap(topY, bottomY);
+        std::swap(topSuccess, bottomSuccess);
+    }
+}
+
+const GeoMetadata& WarpPlan::source_metadata() const noexcept
+{
+    return _srcMeta;
+}
+
+const GeoMetadata& WarpPlan::destination_metadata() const noexcept
+{
+    return _dstMeta;
+}
+
+ResampleAlgorithm WarpPlan::algorithm() const noexcept
+{
+    return _algo;
+}
+
+}
@@ -0,0 +1,305 @@
+#include "infra/gdalzonalstatistics.h"
+#include "infra/cast.h"
+#include "infra/exception.h"
+#include "infra/gdal.h"
+#include "infra/gdalgeometry.h"
+#include "infra/gdalrasterizer.h"
+#include "infra/parallelfor.h"
+#include "infra/rasterstatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+namespace inf::gdal {
+
+namespace {
+
+struct Zone
+{
+    int64_t fid = -1;
+    Owner<GeometryRef> geometry; // null for features without polygon geometry
+};
+
+// Reads the cells of a window of an in memory raster
+template <typename T>
+class SpanReader
+{
+public:
+    using value_type = T;
+
+    SpanReader(std::span<const T> data, int32_t cols)
+    : _data(data)
+    , _cols(cols)
+    {
+    }
+
+    void read(int32_t colOffset, int32_t rowOffset, int32_t cols, int32_t rows, T* result) const
+    {
+        for (int32_t row = 0; row < rows; ++row) {
+            const auto* rowData = _data.data() + size_t(rowOffset + row) * _cols + colOffset;
+            std::copy(rowData, rowData + cols, result + size_t(row) * cols);
+        }
+    }
+
+private:
+    std::span<const T> _data;
+    int32_t _cols;
+};
+
+// Reads the cells of a window of a raster band as T, every thread has its own instance
+template <typename T>
+class DataSetReader
+{
+public:
+    using value_type = T;
+
+    DataSetReader(const fs::path& rasterPath, int bandNr)
+    : _dataSet(RasterDataSet::open(rasterPath))
+    , _bandNr(bandNr)
+    {
+    }
+
+    void read(int32_t colOffset, int32_t rowOffset, int32_t cols, int32_t rows, T* result) const
+    {
+        _dataSet.read_rasterdata<T>(_bandNr, colOffset, rowOffset, cols, rows, result, cols, rows);
+    }
+
+private:
+    RasterDataSet _dataSet;
+    int _bandNr;
+};
+
+template <typename Reader>
+struct ThreadState
+{
+    Reader reader;
+    std::vector<typename Reader::value_type> data;
+    std::vector<float> weights;
+    std::unordered_map<double, double> frequencies;
+};
+
+std::vector<Zone> read_zones(Layer& layer)
+{
+    std::vector<Zone> zones;
+    zones.reserve(std::max<int64_t>(0, layer.feature_count()));
+
+    for (auto& feature : layer) {
+        Zone zone;
+        zone.fid = feature.id();
+        if (feature.has_geometry()) {
+            auto geometry = feature.geometry();
+            if (geometry.type() == Geometry::Type::Polygon || geometry.type() == Geometry::Type::MultiPolygon) {
+                zone.geometry = geometry.clone();
+            }
+        }
+
+        zones.push_back(std::move(zone));
+    }
+
+    return zones;
+}
+
+// The cells of the raster that overlap with the envelope of the geometry, empty when there is no overlap
+GeoMetadata zone_window(GeometryCRef geometry, const GeoMetadata& meta, int32_t& colOffset, int32_t& rowOffset)
+{
+    const auto envelope   = geometry.envelope();
+    const auto topLeft    = meta.top_left();
+    const auto cellHeight = std::abs(meta.cellSize.y);
+
+    auto toCell = [](double value, int32_t count) {
+        return int32_t(std::clamp(value, 0.0, double(count)));
+    };
+
+    const auto colBegin = toCell(std::floor((envelope.top_left().x - topLeft.x) / meta.cellSize.x), meta.cols);
+    const auto colEnd   = toCell(std::ceil((envelope.bottom_right().x - topLeft.x) / meta.cellSize.x), meta.cols);
+    const auto rowBegin = toCell(std::floor((topLeft.y - envelope.top_left().y) / cellHeight), meta.rows);
+    const auto rowEnd   = toCell(std::ceil((topLeft.y - envelope.bottom_right().y) / cellHeight), meta.rows);
+
+    auto window = meta;
+    window.cols = std::max(0, colEnd - colBegin);
+    window.rows = std::max(0, rowEnd - rowBegin);
+    window.xll  = topLeft.x + colBegin * meta.cellSize.x;
+    window.yll  = topLeft.y - rowEnd * cellHeight;
+
+    colOffset = colBegin;
+    rowOffset = rowBegin;
+    return window;
+}
+
+template <typename Reader>
+ZonalStatistics zone_statistics(const Zone& zone, const GeoMetadata& meta, const ZonalStatisticsOptions& options, ThreadState<Reader>& state)
+{
+    ZonalStatistics result;
+    result.fid = zone.fid;
+    if (!zone.geometry) {
+        return result;
+    }
+
+    int32_t colOffset = 0, rowOffset = 0;
+    const auto window = zone_window(zone.geometry, meta, colOffset, rowOffset);
+    if (window.rows == 0 || window.cols == 0) {
+        return result;
+    }
+
+    const auto cellCount = size_t(window.rows) * window.cols;
+    state.weights.assign(cellCount, 0.f);
+
+    GeometryCRef geometry(zone.geometry);
+    if (options.coverageWeighting) {
+        if (geometry.type() == Geometry::Type::Polygon) {
+            polygon_coverage(geometry.as<PolygonCRef>(), window, state.weights);
+        } else {
+            polygon_coverage(geometry.as<MultiPolygonCRef>(), window, state.weights);
+        }
+    } else {
+        if (geometry.type() == Geometry::Type::Polygon) {
+            burn_polygon<float>(geometry.as<PolygonCRef>(), window, 1.f, state.weights);
+        } else {
+            burn_polygon<float>(geometry.as<MultiPolygonCRef>(), window, 1.f, state.weights);
+        }
+    }
+
+    if (std::none_of(state.weights.begin(), state.weights.end(), [](float weight) { return weight > 0.f; })) {
+        return result;
+    }
+
+    state.data.resize(cellCount);
+    state.reader.read(colOffset, rowOffset, window.cols, window.rows, state.data.data());
+    state.frequencies.clear();
+
+    // the nodata is compared in the type of the raster
+    const detail::NodataMatcher<typename Reader::value_type> isNodata(meta.nodata);
+
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < cellCount; ++i) {
+        const auto weight = double(state.weights[i]);
+        if (weight <= 0.0 || isNodata(state.data[i])) {
+            continue;
+        }
+
+        const auto value = static_cast<double>(state.data[i]);
+
+        result.count += weight;
+        result.sum += weight * value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+
+        if (options.majority) {
+            state.frequencies[value] += weight;
+        }
+    }
+
+    if (result.count > 0.0) {
+        result.mean = result.sum / result.count;
+        result.min  = min;
+        result.max  = max;
+    }
+
+    if (!state.frequencies.empty()) {
+        auto majority = *state.frequencies.begin();
+        for (auto& [value, frequency] : state.frequencies) {
+            if (frequency > majority.second || (frequency == majority.second && value < majority.first)) {
+                majority = {value, frequency};
+            }
+        }
+
+        result.majority = majority.first;
+    }
+
+    return result;
+}
+
+template <typename StateFactory>
+std::vector<ZonalStatistics> compute_zonal_statistics(Layer& layer, const GeoMetadata& meta, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb, StateFactory&& createState)
+{
+    // the layer is read sequentially, the zones are processed in parallel
+    const auto zones = read_zones(layer);
+    std::vector<ZonalStatistics> result(zones.size());
+
+    ProgressInfo progress(truncate<int64_t>(zones.size()), progressCb);
+    std::mutex progressMutex;
+
+    parallel_for(truncate<int64_t>(zones.size()), options.threadCount, createState, [&](auto& state, int64_t index) {
+        result[index] = zone_statistics(zones[index], meta, options, state);
+
+        std::scoped_lock lock(progressMutex);
+        progress.tick_throw_on_cancel();
+    });
+
+    return result;
+}
+
+}
+
+std::vector<ZonalStatistics> zonal_statistics(const fs::path& rasterPath, int bandNr, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb)
+{
+    auto dataSet    = RasterDataSet::open(rasterPath);
+    const auto meta = dataSet.geometadata(bandNr);
+
+    // integral band values are exact as double, float bands are read as float to compare the nodata as float
+    if (dataSet.band_datatype(bandNr) == typeid(float)) {
+        return compute_zonal_statistics(layer, meta, options, progressCb, [&]() {
+            return ThreadState<DataSetReader<float>>{DataSetReader<float>(rasterPath, bandNr), {}, {}, {}};
+        });
+    }
+
+    return compute_zonal_statistics(layer, meta, options, progressCb, [&]() {
+        return ThreadState<DataSetReader<double>>{DataSetReader<double>(rasterPath, bandNr), {}, {}, {}};
+    });
+}
+
+template <typename T>
+std::vector<ZonalStatistics> zonal_statistics(std::span<const T> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb)
+{
+    if (data.size() != size_t(meta.rows) * size_t(meta.cols)) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    return compute_zonal_statistics(layer, meta, options, progressCb, [&]() {
+        return ThreadState<SpanReader<T>>{SpanReader<T>(data, meta.cols), {}, {}, {}};
+    });
+}
+
+void write_zonal_statistics(Layer& layer, std::span<const ZonalStatistics> statistics, const ZonalStatisticsOptions& options, const std::string& fieldPrefix)
+{
+    std::vector<std::string> fieldNames = {"count", "sum", "mean", "min", "max"};
+    if (options.majority) {
+        fieldNames.emplace_back("majority");
+    }
+
+    for (auto& name : fieldNames) {
+        name = fieldPrefix + name;
+        if (layer.field_index(name) < 0) {
+            auto def = FieldDefinition::create<double>(name);
+            layer.create_field(def);
+        }
+    }
+
+    for (auto& stats : statistics) {
+        auto feature = layer.feature(stats.fid);
+
+        const double values[] = {stats.count, stats.sum, stats.mean, stats.min, stats.max, stats.majority};
+        for (size_t i = 0; i < fieldNames.size(); ++i) {
+            const auto fieldIndex = feature.field_index(fieldNames[i]);
+            if (std::isnan(values[i])) {
+                feature.set_field_to_null(fieldIndex);
+            } else {
+                feature.set_field(fieldIndex, values[i]);
+            }
+        }
+
+        layer.set_feature(feature);
+    }
+}
+
+template std::vector<ZonalStatistics> zonal_statistics<float>(std::span<const float> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb);
+template std::vector<ZonalStatistics> zonal_statistics<double>(std::span<const double> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb);
+template std::vector<ZonalStatistics> zonal_statistics<int32_t>(std::span<const int32_t> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb);
+template std::vector<ZonalStatistics> zonal_statistics<int16_t>(std::span<const int16_t> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb);
+template std::vector<ZonalStatistics> zonal_statistics<uint16_t>(std::span<const uint16_t> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb);
+template std::vector<ZonalStatistics> zonal_statistics<uint8_t>(std::span<const uint8_t> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options, const ProgressInfo::Callback& progressCb);
+
+}
@@ -1,11 +1,15 @@
 #include "infra/geometry.h"
 
 #include "infra/algo.h"
+#include "infra/cast.h"
 #include "infra/chrono.h"
 #include "infra/exception.h"
 #include "infra/log.h"
 
+#include "infra/gdalalgo.h"
 #include "infra/gdalgeometry.h"
+#include "infra/gdalio.h"
+#include "infra/parallelfor.h"
 
 #include <geos/geom/Coordinate.h>
 #include <geos/geom/Geometry.h>
@@ -23,7 +27,10 @@
 #endif
 
 #include <cassert>
+#include <cmath>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace inf::geom {
@@ -166,6 +173,158 @@ void calculate_geometry_envelopes(const geos::geom::Geometry& geom)
     }
 }
 
+static std::unique_ptr<OGRLinearRing> geos_linear_ring_to_gdal(const geos::geom::LinearRing& ring)
+{
+    auto result = std::make_unique<OGRLinearRing>();
+
+    const auto* coords = ring.getCoordinatesRO();
+    result->setNumPoints(truncate<int>(coords->size()));
+    for (size_t i = 0; i < coords->size(); ++i) {
+        const auto& coord = coords->getAt(i);
+        result->setPoint(truncate<int>(i), coord.x, coord.y);
+    }
+
+    return result;
+}
+
+static gdal::Owner<gdal::PolygonRef> geos_polygon_to_gdal(const geos::geom::Polygon& poly)
+{
+    gdal::Owner<gdal::PolygonRef> result(new OGRPolygon());
+    result.get()->addRingDirectly(geos_linear_ring_to_gdal(*poly.getExteriorRing()).release());
+
+    for (size_t i = 0; i < poly.getNumInteriorRing(); ++i) {
+        result.get()->addRingDirectly(geos_linear_ring_to_gdal(*poly.getInteriorRingN(i)).release());
+    }
+
+    return result;
+}
+
+// The polygonized vertices of a tile are computed from the tile origin, so the coordinates of a shared tile edge can differ
+// in the last bits for cell sizes that are not exact in binary (e.g. 0.1). Recompute them from the global column and row
+// so the same grid corner always gets bit identical coordinates.
+static void snap_to_grid(OGRLinearRing& ring, const GeoMetadata& meta)
+{
+    const auto cellWidth  = meta.cellSize.x;
+    const auto cellHeight = std::abs(meta.cellSize.y);
+
+    for (int i = 0; i < ring.getNumPoints(); ++i) {
+        const auto col = std::round((ring.getX(i) - meta.xll) / cellWidth);
+        const auto row = std::round((ring.getY(i) - meta.yll) / cellHeight);
+        ring.setPoint(i, meta.xll + col * cellWidth, meta.yll + row * cellHeight);
+    }
+}
+
+static void snap_to_grid(gdal::GeometryRef geometry, const GeoMetadata& meta)
+{
+    if (geometry.type() != gdal::Geometry::Type::Polygon) {
+        return;
+    }
+
+    auto* polygon = geometry.as<gdal::PolygonRef>().get();
+    if (auto* ring = polygon->getExteriorRing(); ring != nullptr) {
+        snap_to_grid(*ring, meta);
+    }
+
+    for (int i = 0; i < polygon->getNumInteriorRings(); ++i) {
+        snap_to_grid(*polygon->getInteriorRing(i), meta);
+    }
+}
+
+void polygonize_tiled(const fs::path& rasterPath, gdal::Layer& layer, const PolygonizeTileOptions& options)
+{
+    if (options.tileSize <= 0) {
+        throw InvalidArgument("Invalid polygonize tile size: {}", options.tileSize);
+    }
+
+    const auto meta = gdal::io::read_metadata(rasterPath);
+
+    if (layer.field_index("Value") < 0) {
+        gdal::FieldDefinition def("Value", typeid(int32_t));
+        layer.create_field(def);
+    }
+
+    const auto valueField = layer.field_index("Value");
+    const auto tileSize   = options.tileSize;
+    const auto tileRows   = (meta.rows + tileSize - 1) / tileSize;
+    const auto tileCols   = (meta.cols + tileSize - 1) / tileSize;
+    const auto cellWidth  = meta.cellSize.x;
+    const auto cellHeight = std::abs(meta.cellSize.y);
+    const auto tolerance  = std::min(cellWidth, cellHeight) / 2.0;
+
+    // the layer can only be written by one thread at a time
+    std::mutex layerMutex;
+    auto writeFeature = [&](int32_t value, auto&& geometry) {
+        std::scoped_lock lock(layerMutex);
+        gdal::Feature feature(layer.layer_definition());
+        feature.set_field(valueField, value);
+        feature.set_geometry(std::move(geometry));
+        layer.create_feature(feature);
+    };
+
+    std::mutex seamMutex;
+    std::unordered_map<int32_t, std::vector<std::unique_ptr<geos::geom::Geometry>>> seamPolygons;
+
+    parallel_for(
+        int64_t(tileRows) * tileCols, options.threadCount, [&]() { return gdal::RasterDataSet::open(rasterPath); },
+        [&](gdal::RasterDataSet& ds, int64_t tileIndex) {
+            const auto rowOffset = int32_t(tileIndex / tileCols) * tileSize;
+            const auto colOffset = int32_t(tileIndex % tileCols) * tileSize;
+
+            auto tileMeta = meta;
+            tileMeta.rows = std::min(tileSize, meta.rows - rowOffset);
+            tileMeta.cols = std::min(tileSize, meta.cols - colOffset);
+            tileMeta.xll  = meta.xll + colOffset * cellWidth;
+            tileMeta.yll  = meta.yll + (meta.rows - rowOffset - tileMeta.rows) * cellHeight;
+
+            std::vector<int32_t> data(size_t(tileMeta.rows) * tileMeta.cols);
+            ds.read_rasterdata<int32_t>(1, colOffset, rowOffset, tileMeta.cols, tileMeta.rows, data.data(), tileMeta.cols, tileMeta.rows);
+            auto polygons = gdal::polygonize(std::span<const int32_t>(data), tileMeta);
+
+            // only the tile edges that are shared with another tile are seams
+            const auto bbox       = tileMeta.bounding_box();
+            const bool seamLeft   = colOffset > 0;
+            const bool seamRight  = colOffset + tileMeta.cols < meta.cols;
+            const bool seamTop    = rowOffset > 0;
+            const bool seamBottom = rowOffset + tileMeta.rows < meta.rows;
+
+            for (auto& feature : polygons.layer(0)) {
+                const auto value = feature.field_as<int32_t>(0);
+                auto geometry    = feature.geometry();
+                snap_to_grid(geometry, meta);
+                const auto env = geometry.envelope();
+
+                const bool onSeam = (seamLeft && env.get()->MinX < bbox.topLeft.x + tolerance) ||
+                                    (seamRight && env.get()->MaxX > bbox.bottomRight.x - tolerance) ||
+                                    (seamTop && env.get()->MaxY > bbox.topLeft.y - tolerance) ||
+                                    (seamBottom && env.get()->MinY < bbox.bottomRight.y + tolerance);
+
+                if (onSeam) {
+                    auto geosGeometry = gdal_to_geos(geometry);
+                    std::scoped_lock lock(seamMutex);
+                    seamPolygons[value].push_back(std::move(geosGeometry));
+                } else {
+                    writeFeature(value, geometry);
+                }
+            }
+        });
+
+    // merge the polygons that cross the seams, the union of the polygons of a value can consist of multiple polygons
+    std::vector<std::pair<int32_t, std::vector<std::unique_ptr<geos::geom::Geometry>>>> seamGroups(std::make_move_iterator(seamPolygons.begin()), std::make_move_iterator(seamPolygons.end()));
+    seamPolygons.clear();
+
+    parallel_for(truncate<int64_t>(seamGroups.size()), options.threadCount, [&](int64_t index) {
+        auto& [value, geometries] = seamGroups[index];
+
+        auto factory = geos::geom::GeometryFactory::create();
+        auto merged  = factory->buildGeometry(std::move(geometries))->Union();
+        for (size_t i = 0; i < merged->getNumGeometries(); ++i) {
+            if (const auto* polygon = dynamic_cast<const geos::geom::Polygon*>(merged->getGeometryN(i)); polygon != nullptr) {
+                writeFeature(value, geos_polygon_to_gdal(*polygon));
+            }
+        }
+    });
+}
+
 CoordinateWarpFilter::CoordinateWarpFilter(int32_t sourceEpsg, int32_t destEpsg)
 : _transformer(sourceEpsg, destEpsg)
 {
@@ -4,6 +4,7 @@
 #include "infra/filesystem.h"
 #include "infra/gdal-private.h"
 #include "infra/gdalgeometry.h"
+#include "infra/gdalmetrics.h"
 #include "infra/gdalresample.h"
 #include "infra/gdalspatialreference.h"
 #include "infra/geometadata.h"
@@ -140,6 +141,13 @@ enum class OpenMode
     ReadWrite,
 };
 
+/*! Memory layout of multi band raster data */
+enum class BandInterleave
+{
+    Pixel, // BIP: the values of all the bands of a cell are stored next to each other
+    Band,  // BSQ: the values of a band are stored contiguously, followed by the values of the next band
+};
+
 struct RasterStats
 {
     double min    = std::numeric_limits<double>::quiet_NaN();
@@ -202,6 +210,7 @@ public:
     template <typename T>
     void read_rasterdata(int band, int xOff, int yOff, int xSize, int ySize, T* pData, int bufXSize, int bufYSize, int pixelSize = 0, int lineSize = 0) const
     {
+        IoMetricsScope metrics(IoOperation::Read, _ptr, uint64_t(bufXSize) * uint64_t(bufYSize) * sizeof(T));
         auto* bandPtr = _ptr->GetRasterBand(band);
         check_error(bandPtr->RasterIO(GF_Read, xOff, yOff, xSize, ySize, pData, bufXSize, bufYSize, TypeResolve<T>::value, pixelSize, lineSize),
                     "Failed to read raster data");
@@ -224,6 +233,7 @@ public:
     template <typename T>
     void write_rasterdata(int band, int xOff, int yOff, int xSize, int ySize, const T* pData, int bufXSize, int bufYSize) const
     {
+        IoMetricsScope metrics(IoOperation::Write, _ptr, uint64_t(bufXSize) * uint64_t(bufYSize) * sizeof(T));
         auto* bandPtr = check_pointer(_ptr->GetRasterBand(band), "Failed to get raster band for writing");
         auto* dataPtr = const_cast<void*>(static_cast<const void*>(pData));
         check_error(bandPtr->RasterIO(GF_Write, xOff, yOff, xSize, ySize, dataPtr, bufXSize, bufYSize, TypeResolve<T>::value, 0, 0),
@@ -233,6 +243,43 @@ public:
     void read_rasterdata(int band, int xOff, int yOff, int x_size, int y_size, const std::type_info& type, void* pData, int bufXSize, int bufYSize, int pixelSize = 0, int lineSize = 0) const;
     void write_rasterdata(int band, int xOff, int yOff, int x_size, int y_size, const std::type_info& type, const void* pData, int bufXSize, int bufYSize) const;
 
+    /*! Reads the window of multiple bands in a single call, so pixel interleaved data is only decoded once
+     * bands: the band numbers to read (1-based), an empty list reads all the bands
+     * The buffer contains bufXSize * bufYSize values for every band in the requested interleave
+     */
+    template <typename T>
+    void read_rasterdata(std::span<const int> bands, int xOff, int yOff, int xSize, int ySize, std::span<T> data, int bufXSize, int bufYSize, BandInterleave interleave) const
+    {
+        check_multiband_buffer_size(bands, data.size(), bufXSize, bufYSize);
+        read_rasterdata(bands, xOff, yOff, xSize, ySize, typeid(T), data.data(), bufXSize, bufYSize, interleave);
+    }
+
+    /*
+     * Convenience method that returns the full raster of the bands as a vector
+     */
+    template <typename T>
+    std::vector<T> read_rasterdata(std::span<const int> bands, BandInterleave interleave) const
+    {
+        const auto xSize     = x_size();
+        const auto ySize     = y_size();
+        const auto bandCount = bands.empty() ? raster_count() : int(bands.size());
+
+        std::vector<T> result(size_t(xSize) * ySize * bandCount);
+        read_rasterdata<T>(bands, 0, 0, xSize, ySize, std::span<T>(result), xSize, ySize, interleave);
+        return result;
+    }
+
+    /*! Writes the window of multiple bands in a single call, the layout of the data is the same as for the multi band read */
+    template <typename T>
+    void write_rasterdata(std::span<const int> bands, int xOff, int yOff, int xSize, int ySize, std::span<const T> data, int bufXSize, int bufYSize, BandInterleave interleave) const
+    {
+        check_multiband_buffer_size(bands, data.size(), bufXSize, bufYSize);
+        write_rasterdata(bands, xOff, yOff, xSize, ySize, typeid(T), data.data(), bufXSize, bufYSize, interleave);
+    }
+
+    void read_rasterdata(std::span<const int> bands, int xOff, int yOff, int xSize, int ySize, const std::type_info& type, void* pData, int bufXSize, int bufYSize, BandInterleave interleave) const;
+    void write_rasterdata(std::span<const int> bands, int xOff, int yOff, int xSize, int ySize, const std::type_info& type, const void* pData, int bufXSize, int bufYSize, BandInterleave interleave) const;
+
     void write_geometadata(const GeoMetadata& meta);
     GeoMetadata geometadata() const;
     GeoMetadata geometadata(int bandNr) const;
@@ -263,6 +310,7 @@ public:
 
 private:
     RasterDriver driver() const;
+    void check_multiband_buffer_size(std::span<const int> bands, size_t bufferSize, int bufXSize, int bufYSize) const;
 
     GDALDataset* _ptr = nullptr;
 };
@@ -375,6 +423,9 @@ public:
 
     RasterDataSet create_dataset_copy(const RasterDataSet& reference, const fs::path& filename, std::span<const std::string> driverOptions = {});
 
+    // Some drivers can only create datasets using create_dataset_copy
+    bool supports_create() const;
+
     RasterType type() const;
 
 private:
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "infra/cast.h"
+#include "infra/exception.h"
+#include "infra/gdalresample.h"
+#include "infra/geometadata.h"
+#include "infra/parallelfor.h"
+#include "infra/rasterstatistics.h"
+#include "infra/span.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace inf::gdal {
+
+/*! The metadata of a raster that is aggregated with the given integer factor, the cells of the result are aligned with the cells of the input
+ * When the number of rows or columns is not a multiple of the factor, the last row or column of the result covers the remaining cells
+ */
+inline GeoMetadata aggregate_metadata(const GeoMetadata& meta, int32_t factor)
+{
+    if (factor < 1) {
+        throw InvalidArgument("Invalid aggregation factor: {}", factor);
+    }
+
+    auto result = meta;
+    result.rows = (meta.rows + factor - 1) / factor;
+    result.cols = (meta.cols + factor - 1) / factor;
+    result.yll  = meta.yll + (meta.rows - result.rows * factor) * std::abs(meta.cellSize.y);
+    result.cellSize *= double(factor);
+    return result;
+}
+
+namespace detail {
+
+// Accumulates the source cells of one destination row, every source row is processed as a contiguous run of cells
+template <typename T, typename TAccumulator, typename Accumulate>
+void accumulate_aggregation_row(std::span<const T> data, const GeoMetadata& meta, int32_t factor, int32_t dstRow, std::vector<TAccumulator>& acc, std::vector<int32_t>& count, Accumulate&& accumulate)
+{
+    const inf::detail::NodataMatcher<T> isNodata(meta.nodata);
+    const auto endRow = std::min(meta.rows, (dstRow + 1) * factor);
+
+    for (int32_t row = dstRow * factor; row < endRow; ++row) {
+        const T* rowData = data.data() + size_t(row) * meta.cols;
+
+        int32_t dstCol = 0;
+        for (int32_t col = 0; col < meta.cols; col += factor, ++dstCol) {
+            const auto endCol = std::min(meta.cols, col + factor);
+
+            auto cellAcc   = acc[dstCol];
+            auto cellCount = count[dstCol];
+            for (int32_t c = col; c < endCol; ++c) {
+                const auto value = rowData[c];
+                if (!isNodata(value)) {
+                    cellAcc = accumulate(cellAcc, value);
+                    ++cellCount;
+                }
+            }
+
+            acc[dstCol]   = cellAcc;
+            count[dstCol] = cellCount;
+        }
+    }
+}
+
+template <typename T>
+T most_frequent_value(std::vector<T>& values) noexcept
+{
+    // on a tie the smallest value is selected
+    std::sort(values.begin(), values.end());
+
+    T mode           = values.front();
+    size_t modeCount = 0;
+    for (size_t i = 0; i < values.size();) {
+        size_t j = i;
+        while (j < values.size() && values[j] == values[i]) {
+            ++j;
+        }
+
+        if (j - i > modeCount) {
+            mode      = values[i];
+            modeCount = j - i;
+        }
+
+        i = j;
+    }
+
+    return mode;
+}
+
+}
+
+/*! Aggregates the raster with an integer factor (e.g. 10m to 100m with a factor of 10) without going through the gdal warper
+ * Supported algorithms: NearestNeighbour (the cell at the centre of the block), Average, Sum, Minimum, Maximum and Mode
+ * Nodata (and NaN) cells are ignored, a result cell is nodata when all the cells in its block are nodata.
+ * The nodata is compared in the type of the input, a nodata value that does not fit in the type matches no cells.
+ * When the input has no nodata value, the result nodata value is set as in warp_raster.
+ * The rows of the result are processed using multiple threads (0: default_thread_count)
+ */
+template <typename T, typename TResult>
+GeoMetadata aggregate_raster(std::span<const T> data, const GeoMetadata& meta, int32_t factor, std::span<TResult> result, ResampleAlgorithm algo, uint32_t threadCount = 0)
+{
+    if (truncate<int32_t>(data.size()) != meta.rows * meta.cols) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    auto resultMeta = aggregate_metadata(meta, factor);
+    if (truncate<int32_t>(result.size()) != resultMeta.rows * resultMeta.cols) {
+        throw InvalidArgument("Invalid result buffer provided: incorrect size");
+    }
+
+    if (!resultMeta.nodata.has_value()) {
+        if constexpr (std::numeric_limits<TResult>::has_quiet_NaN) {
+            resultMeta.nodata = std::numeric_limits<TResult>::quiet_NaN();
+        } else {
+            resultMeta.nodata = std::numeric_limits<TResult>::max();
+        }
+    }
+
+    const auto dstNodata = static_cast<TResult>(*resultMeta.nodata);
+    const auto dstCols   = resultMeta.cols;
+
+    auto toResult = [](double value) {
+        if constexpr (std::is_integral_v<TResult>) {
+            return static_cast<TResult>(std::round(value));
+        } else {
+            return static_cast<TResult>(value);
+        }
+    };
+
+    auto reduceRows = [&](auto initialValue, auto&& accumulate, auto&& finish) {
+        using Accumulator = decltype(initialValue);
+
+        parallel_for(
+            resultMeta.rows, threadCount, [&]() { return std::pair(std::vector<Accumulator>(dstCols), std::vector<int32_t>(dstCols)); },
+            [&](auto& state, int64_t dstRow) {
+                auto& [acc, count] = state;
+                std::fill(acc.begin(), acc.end(), initialValue);
+                std::fill(count.begin(), count.end(), 0);
+                detail::accumulate_aggregation_row(data, meta, factor, int32_t(dstRow), acc, count, accumulate);
+
+                auto* dstData = result.data() + size_t(dstRow) * dstCols;
+                for (int32_t col = 0; col < dstCols; ++col) {
+                    dstData[col] = count[col] == 0 ? dstNodata : finish(acc[col], count[col]);
+                }
+            });
+    };
+
+    switch (algo) {
+    case ResampleAlgorithm::NearestNeighbour:
+        parallel_for(resultMeta.rows, threadCount, [&](int64_t dstRow) {
+            const inf::detail::NodataMatcher<T> isNodata(meta.nodata);
+            const auto row = std::min(meta.rows - 1, int32_t(dstRow) * factor + factor / 2);
+            auto* dstData  = result.data() + size_t(dstRow) * dstCols;
+            for (int32_t col = 0; col < dstCols; ++col) {
+                const auto value = data[size_t(row) * meta.cols + std::min(meta.cols - 1, col * factor + factor / 2)];
+                dstData[col]     = isNodata(value) ? dstNodata : static_cast<TResult>(value);
+            }
+        });
+        break;
+    case ResampleAlgorithm::Average:
+        reduceRows(
+            0.0, [](double acc, T value) { return acc + double(value); }, [&](double acc, int32_t count) { return toResult(acc / count); });
+        break;
+#if GDAL_VERSION_NUM >= 3010000
+    case ResampleAlgorithm::Sum:
+        reduceRows(
+            0.0, [](double acc, T value) { return acc + double(value); }, [&](double acc, int32_t) { return toResult(acc); });
+        break;
+#endif
+    case ResampleAlgorithm::Minimum:
+        reduceRows(
+            std::numeric_limits<T>::max(), [](T acc, T value) { return std::min(acc, value); }, [](T acc, int32_t) { return static_cast<TResult>(acc); });
+        break;
+    case ResampleAlgorithm::Maximum:
+        reduceRows(
+            std::numeric_limits<T>::lowest(), [](T acc, T value) { return std::max(acc, value); }, [](T acc, int32_t) { return static_cast<TResult>(acc); });
+        break;
+    case ResampleAlgorithm::Mode:
+        parallel_for(
+            resultMeta.rows, threadCount, []() { return std::vector<T>(); },
+            [&](std::vector<T>& values, int64_t dstRow) {
+                const inf::detail::NodataMatcher<T> isNodata(meta.nodata);
+                const auto beginRow = int32_t(dstRow) * factor;
+                const auto endRow   = std::min(meta.rows, beginRow + factor);
+                auto* dstData       = result.data() + size_t(dstRow) * dstCols;
+                for (int32_t col = 0; col < dstCols; ++col) {
+                    values.clear();
+                    const auto beginCol = col * factor;
+                    const auto endCol   = std::min(meta.cols, beginCol + factor);
+                    for (int32_t r = beginRow; r < endRow; ++r) {
+                        for (int32_t c = beginCol; c < endCol; ++c) {
+                            if (auto value = data[size_t(r) * meta.cols + c]; !isNodata(value)) {
+                                values.push_back(value);
+                            }
+                        }
+                    }
+
+                    dstData[col] = values.empty() ? dstNodata : static_cast<TResult>(detail::most_frequent_value(values));
+                }
+            });
+        break;
+    default:
+        throw InvalidArgument("Unsupported aggregation algorithm: {}", resample_algo_to_string(algo));
+    }
+
+    return resultMeta;
+}
+
+}
@@ -38,6 +38,39 @@ void warp_to_disk(const RasterDataSet& srcDataSet, const GeoMetadata& destMeta,
     io::write_raster(std::span<const T>(result), meta, output, driverOptions);
 }
 
+struct WarpChunkOptions
+{
+    double memoryLimit = 256.0 * 1024 * 1024; //! memory used by the warper for a single chunk (in bytes), larger destination areas are split
+    bool overlapIo     = true;                //! overlap the reading and writing of a chunk with the warping of the next chunk
+};
+
+/*! Warps the source directly into a dataset on disk, the destination is processed in chunks that fit within the memory limit
+ * so the full result is never kept in memory, every chunk is warped using all cores.
+ * The output format has to support direct creation (e.g. GeoTiff), with the default driver options a tiled GeoTiff is created.
+ * The destination cells that are not covered by the source are initialized with nodata.
+ */
+void warp_chunked(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, WarpOptions& options, const WarpChunkOptions& chunkOptions = {});
+
+template <typename T>
+void warp_to_disk_chunked(const RasterDataSet& srcDataSet, const GeoMetadata& destMeta, const fs::path& output, WarpOptions& options, const WarpChunkOptions& chunkOptions = {}, const std::vector<std::string>& driverOptions = {})
+{
+    auto meta = destMeta;
+    if (!meta.nodata.has_value()) {
+        meta.nodata = std::numeric_limits<T>::max();
+    }
+
+    auto driver = RasterDriver::create(output);
+    if (!driver.supports_create()) {
+        throw InvalidArgument("Chunked warping requires an output format that supports direct creation: {}", output);
+    }
+
+    auto dstOptions = driverOptions.empty() ? io::detail::default_driver_options(driver) : driverOptions;
+    io::detail::create_output_directory_if_needed(output);
+    auto dstDataSet = driver.create_dataset<T>(meta.rows, meta.cols, 1, output, dstOptions);
+    dstDataSet.write_geometadata(meta);
+    warp_chunked(srcDataSet, dstDataSet, options, chunkOptions);
+}
+
 // This version uses the same options as the command line tool
 void warp_cli(const RasterDataSet& srcDataSet, RasterDataSet& dstDataSet, const std::vector<std::string>& options, const std::vector<std::pair<std::string, std::string>>& keyValueOptions);
 void warp_cli(const RasterDataSet& srcDataSet, const fs::path& output, const std::vector<std::string>& options, const std::vector<std::pair<std::string, std::string>>& keyValueOptions);
@@ -94,6 +127,27 @@ std::pair<GeoMetadata, std::vector<T>> rasterize(const VectorDataSet& ds, const
 
 RasterDataSet rasterize_to_disk(const VectorDataSet& ds, const fs::path& path, const std::vector<std::string>& options = {});
 
+struct RasterizeTileOptions
+{
+    int32_t tileSize     = 1024; //! number of rows and columns of the tiles that are rasterized independently
+    uint32_t threadCount = 0;    //! number of threads that rasterize tiles, 0 uses all available cores
+};
+
+/*! Rasterizes the vector dataset in tiles that are processed concurrently, use it for very large target grids
+ * Every thread opens its own copy of the vector dataset and sets a spatial filter on its layers for every tile
+ * so only the features that intersect the tile are burned. The options are the same as for rasterize, but
+ * options that change the spatial filter or the output grid (-sql, -te, -tr, -ts) should not be used.
+ * The result buffer is filled with the tiles, cells that are not burned contain the nodata value of the metadata (or 0)
+ */
+template <typename T>
+GeoMetadata rasterize_tiled(const fs::path& vectorPath, const GeoMetadata& meta, std::span<T> result, const std::vector<std::string>& options = {}, const RasterizeTileOptions& tileOptions = {});
+
+/*! Rasterizes the vector dataset in tiles like rasterize_tiled, the tiles are written to the output file as they are finished
+ * so the full raster is never kept in memory. The output format has to support direct creation (e.g. GeoTiff)
+ */
+template <typename T>
+void rasterize_tiled_to_disk(const fs::path& vectorPath, const GeoMetadata& meta, const fs::path& outputPath, const std::vector<std::string>& options = {}, const RasterizeTileOptions& tileOptions = {}, const std::vector<std::string>& driverOptions = {});
+
 // convert a vector dataset
 VectorDataSet translate_vector(const VectorDataSet& ds, const std::vector<std::string>& options = {});
 VectorDataSet translate_vector_to_disk(const VectorDataSet& ds, const fs::path& path, const std::vector<std::string>& options = {});
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "infra/filesystem.h"
+#include "infra/gdalio.h"
+#include "infra/geometadata.h"
+#include "infra/threadpool.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace inf::gdal::io {
+
+/*! Writes rasters to disk on background threads so the computation can continue while the data is compressed and written
+ * The writer owns (or shares) the raster data until the write is finished.
+ * Submitting a write blocks while the data of the pending writes exceeds the in flight byte limit,
+ * this limits the memory that is kept alive by writes that did not finish yet.
+ * Write errors are reported through the returned future.
+ */
+class AsyncRasterWriter
+{
+public:
+    /*! threadCount: the number of rasters that are written simultaneously
+     *  maxInFlightBytes: the maximum size of the raster data of the pending writes, a single raster that exceeds
+     *  the limit is accepted when there are no other pending writes
+     */
+    explicit AsyncRasterWriter(uint32_t threadCount = 1, size_t maxInFlightBytes = 1024 * 1024 * 1024);
+
+    /*! Waits until all pending writes are finished */
+    ~AsyncRasterWriter();
+
+    AsyncRasterWriter(const AsyncRasterWriter&)            = delete;
+    AsyncRasterWriter& operator=(const AsyncRasterWriter&) = delete;
+
+    /*! Write the raster data using the given storage type, the writer takes ownership of the data */
+    template <typename T>
+    std::future<void> write_raster(std::vector<T> data, GeoMetadata meta, fs::path filename, const std::type_info& storageType, std::vector<std::string> driverOptions = {}, std::unordered_map<std::string, std::string> metadataValues = {})
+    {
+        const auto bytes = data.size() * sizeof(T);
+        return submit(bytes, [data = std::move(data), meta = std::move(meta), filename = std::move(filename), storageType = &storageType, driverOptions = std::move(driverOptions), metadataValues = std::move(metadataValues)]() {
+            io::write_raster(std::span<const T>(data), meta, filename, *storageType, driverOptions, metadataValues);
+        });
+    }
+
+    template <typename T>
+    std::future<void> write_raster(std::vector<T> data, GeoMetadata meta, fs::path filename, std::vector<std::string> driverOptions = {})
+    {
+        return write_raster(std::move(data), std::move(meta), std::move(filename), typeid(T), std::move(driverOptions));
+    }
+
+    /*! Write the raster data using the given storage type, the data is shared with the caller and must not be modified until the write is finished */
+    template <typename T>
+    std::future<void> write_raster(std::shared_ptr<const std::vector<T>> data, GeoMetadata meta, fs::path filename, const std::type_info& storageType, std::vector<std::string> driverOptions = {}, std::unordered_map<std::string, std::string> metadataValues = {})
+    {
+        const auto bytes = data->size() * sizeof(T);
+        return submit(bytes, [data = std::move(data), meta = std::move(meta), filename = std::move(filename), storageType = &storageType, driverOptions = std::move(driverOptions), metadataValues = std::move(metadataValues)]() {
+            io::write_raster(std::span<const T>(*data), meta, filename, *storageType, driverOptions, metadataValues);
+        });
+    }
+
+    template <typename T>
+    std::future<void> write_raster(std::shared_ptr<const std::vector<T>> data, GeoMetadata meta, fs::path filename, std::vector<std::string> driverOptions = {})
+    {
+        return write_raster(std::move(data), std::move(meta), std::move(filename), typeid(T), std::move(driverOptions));
+    }
+
+    /*! Schedules a custom write, bytes is the size of the data that is kept alive by the write function
+     * Blocks while the in flight byte limit would be exceeded, like the write_raster overloads
+     */
+    std::future<void> submit(size_t bytes, std::function<void()> write);
+
+    /*! The number of writes that are queued or in progress */
+    size_t queue_depth() const;
+    /*! The size of the raster data of the writes that are queued or in progress */
+    size_t in_flight_bytes() const;
+    size_t max_in_flight_bytes() const noexcept;
+
+    /*! Blocks until all the pending writes are finished */
+    void wait_until_finished();
+
+private:
+    size_t _maxInFlightBytes;
+    size_t _inFlightBytes = 0;
+    size_t _queueDepth    = 0;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    ThreadPool _pool;
+};
+
+}
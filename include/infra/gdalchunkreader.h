@@ -0,0 +1,201 @@
+#pragma once
+
+#include "infra/exception.h"
+#include "infra/gdal.h"
+#include "infra/gdalio.h"
+#include "infra/geometadata.h"
+#include "infra/span.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace inf::gdal::io {
+
+struct ChunkReaderOptions
+{
+    int32_t minimumRows = 0; //! minimum number of rows in a chunk, rounded up to a multiple of the block height of the band
+    int32_t haloRows    = 0; //! number of extra rows read above and below every chunk
+};
+
+/*! A horizontal strip of a raster band
+ * The data contains the halo rows above the chunk, the chunk rows and the halo rows below the chunk.
+ * Halo rows that fall outside of the raster are filled with nodata.
+ */
+template <typename T>
+struct RasterChunk
+{
+    GeoMetadata meta;        //! metadata of the chunk data (halo rows included)
+    std::span<const T> data; //! chunk data (halo rows included)
+    int32_t rowOffset = 0;   //! row in the raster band of the first chunk row (halo rows excluded)
+    int32_t rows      = 0;   //! number of chunk rows (halo rows excluded)
+    int32_t haloRows  = 0;   //! number of halo rows above and below the chunk rows
+
+    /*! The chunk data without the halo rows */
+    std::span<const T> core_data() const noexcept
+    {
+        return data.subspan(size_t(haloRows) * meta.cols, size_t(rows) * meta.cols);
+    }
+};
+
+/*! Streams a raster band in horizontal chunks that are aligned to the block size of the band
+ * A single buffer is allocated and reused for every chunk, so the memory usage does not depend on the raster size.
+ * The nodata and data type handling is identical to data_from_dataset.
+ * The data of a chunk is only valid until the next chunk is read.
+ */
+template <typename T>
+class RasterChunkReader
+{
+public:
+    RasterChunkReader(const RasterDataSet& dataSet, int bandNr, ChunkReaderOptions options = {})
+    : _dataSet(dataSet)
+    , _bandNr(bandNr)
+    , _haloRows(options.haloRows)
+    {
+        if (options.haloRows < 0 || options.minimumRows < 0) {
+            throw InvalidArgument("Invalid chunk reader options: negative row count");
+        }
+
+        if (dataSet.has_valid_geotransform()) {
+            _meta = dataSet.geometadata(bandNr);
+        } else {
+            _meta.nodata = dataSet.nodata_value(bandNr);
+            _meta.cols   = dataSet.x_size();
+            _meta.rows   = dataSet.y_size();
+        }
+
+        const auto blockRows = std::max(1, dataSet.rasterband(bandNr).block_size().height);
+        _chunkRows           = std::max(options.minimumRows, blockRows);
+        _chunkRows           = ((_chunkRows + blockRows - 1) / blockRows) * blockRows;
+        _chunkRows           = std::max(1, std::min(_chunkRows, _meta.rows));
+
+        _buffer.resize(size_t(_chunkRows + 2 * _haloRows) * _meta.cols);
+    }
+
+    /*! Metadata of the full raster band */
+    const GeoMetadata& metadata() const noexcept
+    {
+        return _meta;
+    }
+
+    /*! Number of rows in a chunk (halo rows excluded), the last chunk can contain less rows */
+    int32_t chunk_rows() const noexcept
+    {
+        return _chunkRows;
+    }
+
+    int32_t chunk_count() const noexcept
+    {
+        return (_meta.rows + _chunkRows - 1) / _chunkRows;
+    }
+
+    RasterChunk<T> read_chunk(int32_t index)
+    {
+        if (index < 0 || index >= chunk_count()) {
+            throw RangeError("Invalid chunk index: {}", index);
+        }
+
+        RasterChunk<T> chunk;
+        chunk.rowOffset = index * _chunkRows;
+        chunk.rows      = std::min(_chunkRows, _meta.rows - chunk.rowOffset);
+        chunk.haloRows  = _haloRows;
+
+        const auto firstRow = chunk.rowOffset - _haloRows;
+        const auto lastRow  = chunk.rowOffset + chunk.rows + _haloRows; // exclusive
+
+        detail::CutOut cutOut;
+        cutOut.srcRowOffset = std::max(0, firstRow);
+        cutOut.dstRowOffset = std::max(0, -firstRow);
+        cutOut.rows         = std::min(lastRow, _meta.rows) - cutOut.srcRowOffset;
+        cutOut.cols         = _meta.cols;
+
+        GeoMetadata chunkMeta = _meta;
+        chunkMeta.rows        = lastRow - firstRow;
+        if (_meta.cellSize.is_valid()) {
+            chunkMeta.yll = _meta.yll + _meta.cellSize.y * (lastRow - _meta.rows);
+        }
+
+        auto chunkData = std::span<T>(_buffer).subspan(0, size_t(chunkMeta.rows) * chunkMeta.cols);
+        chunk.meta     = detail::read_cutout<T>(_dataSet, _bandNr, cutOut, chunkMeta, chunkData);
+        chunk.data     = chunkData;
+        return chunk;
+    }
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = RasterChunk<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        iterator() = default;
+        iterator(RasterChunkReader& reader, int32_t index)
+        : _reader(&reader)
+        , _index(index)
+        {
+            read();
+        }
+
+        iterator& operator++()
+        {
+            ++_index;
+            read();
+            return *this;
+        }
+
+        reference operator*() const noexcept
+        {
+            return _chunk;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_chunk;
+        }
+
+        bool operator==(const iterator& other) const noexcept
+        {
+            return _index == other._index;
+        }
+
+        bool operator!=(const iterator& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void read()
+        {
+            if (_reader != nullptr && _index < _reader->chunk_count()) {
+                _chunk = _reader->read_chunk(_index);
+            }
+        }
+
+        RasterChunkReader* _reader = nullptr;
+        int32_t _index             = 0;
+        RasterChunk<T> _chunk;
+    };
+
+    iterator begin()
+    {
+        return iterator(*this, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(*this, chunk_count());
+    }
+
+private:
+    const RasterDataSet& _dataSet;
+    int _bandNr;
+    int32_t _haloRows  = 0;
+    int32_t _chunkRows = 0;
+    GeoMetadata _meta;
+    std::vector<T> _buffer;
+};
+
+}
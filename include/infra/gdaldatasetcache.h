@@ -0,0 +1,179 @@
+#pragma once
+
+#include "infra/filesystem.h"
+#include "infra/gdal.h"
+#include "infra/geometadata.h"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace inf::gdal {
+
+struct DataSetCacheStats
+{
+    uint64_t hits      = 0; //! number of leases that reused an idle handle
+    uint64_t misses    = 0; //! number of leases that opened a new handle
+    uint64_t evictions = 0; //! number of idle handles closed to stay within the handle limit or because the file changed
+    size_t idleHandles = 0; //! number of open handles that are not leased
+    size_t leases      = 0; //! number of handles that are currently leased
+};
+
+class DataSetCache;
+
+/*! Exclusive access to a cached dataset handle
+ * A leased handle is never shared with other leases, so it can be used without locking on the thread that holds the lease.
+ * The handle is returned to the cache when the lease goes out of scope.
+ */
+template <typename DataSet>
+class DataSetLease
+{
+public:
+    DataSetLease() = default;
+    DataSetLease(DataSetCache* cache, std::string key, int64_t modificationTime, DataSet dataSet) noexcept
+    : _cache(cache)
+    , _key(std::move(key))
+    , _modificationTime(modificationTime)
+    , _dataSet(std::move(dataSet))
+    {
+    }
+
+    DataSetLease(const DataSetLease&)            = delete;
+    DataSetLease& operator=(const DataSetLease&) = delete;
+
+    DataSetLease(DataSetLease&& other) noexcept
+    : _cache(other._cache)
+    , _key(std::move(other._key))
+    , _modificationTime(other._modificationTime)
+    , _dataSet(std::move(other._dataSet))
+    {
+        other._cache = nullptr;
+    }
+
+    DataSetLease& operator=(DataSetLease&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            _cache            = other._cache;
+            _key              = std::move(other._key);
+            _modificationTime = other._modificationTime;
+            _dataSet          = std::move(other._dataSet);
+            other._cache      = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~DataSetLease() noexcept
+    {
+        release();
+    }
+
+    DataSet& operator*() noexcept
+    {
+        return _dataSet;
+    }
+
+    DataSet* operator->() noexcept
+    {
+        return &_dataSet;
+    }
+
+    DataSet& get() noexcept
+    {
+        return _dataSet;
+    }
+
+private:
+    void release() noexcept;
+
+    DataSetCache* _cache = nullptr;
+    std::string _key;
+    int64_t _modificationTime = 0;
+    DataSet _dataSet;
+};
+
+using RasterDataSetLease = DataSetLease<RasterDataSet>;
+using VectorDataSetLease = DataSetLease<VectorDataSet>;
+
+/*! Process wide cache of opened datasets
+ * Opening a dataset parses the file headers and projection information which is expensive for small reads.
+ * Handles are keyed on path, open mode, driver options and modification time of the file (not checked for /vsi paths),
+ * modifying a file on disk invalidates the cached handles of that file.
+ * Handles that are not leased are kept open in least recently used order until the handle limit is exceeded.
+ * The limit only applies to the number of open handles (file descriptors), the cache does not account for memory:
+ * gdal does not report the memory used by a single handle, and the cached raster blocks of all datasets share
+ * the gdal block cache, which is limited separately (GDAL_CACHEMAX, see GDALSetCacheMax).
+ */
+class DataSetCache
+{
+public:
+    /*! The process wide cache instance */
+    static DataSetCache& instance();
+
+    explicit DataSetCache(size_t maxHandles = 64);
+    ~DataSetCache();
+
+    DataSetCache(const DataSetCache&)            = delete;
+    DataSetCache& operator=(const DataSetCache&) = delete;
+
+    /*! The maximum number of open handles (leased and idle), this is not a memory limit
+     * Leased handles are never closed, so the limit can be exceeded when more handles are leased simultaneously */
+    void set_max_handles(size_t maxHandles);
+    size_t max_handles() const;
+
+    RasterDataSetLease open_raster(const fs::path& filePath, OpenMode mode = OpenMode::ReadOnly, const std::vector<std::string>& driverOpts = {});
+    VectorDataSetLease open_vector(const fs::path& filePath, OpenMode mode = OpenMode::ReadOnly, const std::vector<std::string>& driverOpts = {});
+
+    /*! Cached equivalents of io::read_metadata and io::get_raster_type */
+    GeoMetadata read_metadata(const fs::path& filePath, const std::vector<std::string>& driverOpts = {});
+    GeoMetadata read_metadata(const fs::path& filePath, int bandNr, const std::vector<std::string>& driverOpts = {});
+    const std::type_info& get_raster_type(const fs::path& filePath);
+
+    /*! Closes all the idle handles, leased handles are closed when the lease ends */
+    void clear();
+
+    DataSetCacheStats stats() const;
+    void reset_stats();
+
+private:
+    template <typename DataSet>
+    friend class DataSetLease;
+
+    using Handle = std::variant<RasterDataSet, VectorDataSet>;
+
+    struct IdleEntry
+    {
+        std::string key;
+        int64_t modificationTime = 0;
+        Handle handle;
+    };
+
+    std::optional<Handle> take_idle_handle(const std::string& key, int64_t modificationTime);
+    void return_handle(std::string key, int64_t modificationTime, Handle handle) noexcept;
+    void abandon_lease() noexcept;
+    void evict_until_within_handle_limit(size_t reserved, std::vector<Handle>& closedHandles);
+
+    mutable std::mutex _mutex;
+    size_t _maxHandles;
+    std::list<IdleEntry> _idle; // most recently used at the front
+    std::unordered_multimap<std::string, std::list<IdleEntry>::iterator> _idleLookup;
+    DataSetCacheStats _stats;
+};
+
+template <typename DataSet>
+void DataSetLease<DataSet>::release() noexcept
+{
+    if (_cache != nullptr) {
+        _cache->return_handle(std::move(_key), _modificationTime, DataSetCache::Handle(std::move(_dataSet)));
+        _cache = nullptr;
+    }
+}
+
+}
@@ -7,14 +7,19 @@
 #include "infra/filesystem.h"
 #include "infra/gdal.h"
 #include "infra/geometadata.h"
+#include "infra/parallelfor.h"
 #include "infra/point.h"
+#include "infra/simdcast.h"
+#include "infra/size.h"
 #include "infra/span.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fmt/format.h>
 #include <gdal_version.h>
 #include <limits>
 #include <ogr_spatialref.h>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -28,6 +33,71 @@ bool is_vsi_path(const fs::path& path);
 GeoMetadata read_metadata(const fs::path& fileName, const std::vector<std::string>& driverOpts = {});
 const std::type_info& get_raster_type(const fs::path& fileName);
 
+struct RasterViewOptions
+{
+    double scale  = 1.0;          //! the values of the view are: source value * scale + offset
+    double offset = 0.0;          //! the offset that is added after scaling
+    std::optional<double> nodata; //! nodata value of the view, the source nodata cells are remapped to this value (default: the source nodata)
+};
+
+/*! Dataset that exposes in memory raster data as a different data type without making a converted copy
+ * The data is converted (and optionally scaled and nodata remapped) by a VRT band when it is read,
+ * so only the requested blocks are converted, values are rounded and clamped to the range of the view type.
+ * The raster data must outlive the view.
+ */
+class RasterView
+{
+public:
+    RasterView(gdal::RasterDataSet source, gdal::RasterDataSet view) noexcept
+    : _source(std::move(source))
+    , _view(std::move(view))
+    {
+    }
+
+    RasterView(RasterView&&) noexcept = default;
+
+    RasterView& operator=(RasterView&& other) noexcept
+    {
+        // the view references the source, so it has to be closed first
+        _view   = std::move(other._view);
+        _source = std::move(other._source);
+        return *this;
+    }
+
+    gdal::RasterDataSet& dataset() noexcept
+    {
+        return _view;
+    }
+
+    const gdal::RasterDataSet& dataset() const noexcept
+    {
+        return _view;
+    }
+
+private:
+    gdal::RasterDataSet _source; // the memory dataset that wraps the data, declared first so it is destroyed after the view
+    gdal::RasterDataSet _view;
+};
+
+namespace detail {
+RasterView create_raster_view(gdal::RasterDataSet source, const GeoMetadata& meta, const std::type_info& viewType, const RasterViewOptions& options);
+}
+
+/*! Creates a view of the raster data with ViewType as data type, see RasterView */
+template <typename ViewType, typename T>
+RasterView create_raster_view(std::span<const T> rasterData, const GeoMetadata& meta, const RasterViewOptions& options = {})
+{
+    if (rasterData.size() != size_t(meta.rows) * size_t(meta.cols)) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    auto memDriver = gdal::RasterDriver::create(gdal::RasterType::Memory);
+    gdal::RasterDataSet memDataSet(memDriver.create_dataset<T>(meta.rows, meta.cols, 0));
+    memDataSet.add_band(rasterData.data());
+    memDataSet.write_geometadata(meta);
+    return detail::create_raster_view(std::move(memDataSet), meta, typeid(ViewType), options);
+}
+
 namespace detail {
 
 using BBox = inf::Rect<double>;
@@ -57,8 +127,61 @@ void read_raster_data(int bandNr, CutOut cut, const gdal::RasterDataSet& dataSet
 }
 
 void read_raster_data(int bandNr, CutOut cut, const gdal::RasterDataSet& dataSet, const std::type_info& info, void* data, int dataCols);
+
+// A window of a raster with a different cell size than the raster
+struct ResampledWindow
+{
+    double srcColOffset = 0.0; // window in pixel coordinates of the raster (full resolution)
+    double srcRowOffset = 0.0;
+    double srcCols      = 0.0;
+    double srcRows      = 0.0;
+    int dstColOffset    = 0; // the cells of the destination that are covered by the window
+    int dstRowOffset    = 0;
+    int cols            = 0;
+    int rows            = 0;
+};
+
+ResampledWindow intersect_metadata_resampled(const GeoMetadata& srcMeta, const GeoMetadata& dstMeta);
+void read_raster_data_resampled(int bandNr, const ResampledWindow& window, ResampleAlgorithm algorithm, const gdal::RasterDataSet& dataSet, const std::type_info& info, void* data, int dataCols);
 void create_output_directory_if_needed(const fs::path& p);
 
+inline std::vector<std::string> default_driver_options(const gdal::RasterDriver& driver)
+{
+    std::vector<std::string> options;
+    if (driver.type() == gdal::RasterType::GeoTiff) {
+        options.emplace_back("COMPRESS=LZW");
+        options.emplace_back("TILED=YES");
+        options.emplace_back("NUM_THREADS=ALL_CPUS");
+    }
+
+    return options;
+}
+
+inline void write_dataset_copy(
+    gdal::RasterDataSet& dataSet,
+    const GeoMetadata& meta,
+    const fs::path& filename,
+    std::span<const std::string> driverOptions,
+    const std::unordered_map<std::string, std::string>& metadataValues,
+    const GDALColorTable* ct = nullptr)
+{
+    dataSet.set_colortable(1, ct);
+    dataSet.write_geometadata(meta);
+
+    auto driver = gdal::RasterDriver::create(filename);
+    std::vector<std::string> options;
+    if (driverOptions.empty()) {
+        options       = default_driver_options(driver);
+        driverOptions = options;
+    }
+
+    for (auto& [key, value] : metadataValues) {
+        dataSet.set_metadata(key, value);
+    }
+
+    driver.create_dataset_copy(dataSet, filename, driverOptions);
+}
+
 template <typename RasterDataType>
 void write_raster_dataset(
     std::span<const RasterDataType> data,
@@ -70,23 +193,52 @@ void write_raster_dataset(
     const GDALColorTable* ct = nullptr)
 {
     memDataSet.add_band(data.data());
-    memDataSet.set_colortable(1, ct);
-    memDataSet.write_geometadata(meta);
+    write_dataset_copy(memDataSet, meta, filename, driverOptions, metadataValues, ct);
+}
 
-    auto driver = gdal::RasterDriver::create(filename);
+/*! Writes the data converted to the storage type without making a converted copy of the full raster
+ * The data is converted in strips that are aligned to the block height of the output dataset
+ * into a buffer that is reused for every strip, requires a driver that supports create_dataset
+ * Values are rounded and clamped to the storage type by gdal, the same conversion as the raster view
+ * that is used for drivers that only support create_dataset_copy.
+ */
+template <typename StorageType, typename RasterDataType>
+void write_raster_dataset_converted(
+    std::span<const RasterDataType> data,
+    gdal::RasterDriver& driver,
+    const GeoMetadata& meta,
+    const fs::path& filename,
+    std::span<const std::string> driverOptions,
+    const std::unordered_map<std::string, std::string>& metadataValues,
+    const GDALColorTable* ct = nullptr)
+{
     std::vector<std::string> options;
-    if (driverOptions.empty() && driver.type() == gdal::RasterType::GeoTiff) {
-        options.emplace_back("COMPRESS=LZW");
-        options.emplace_back("TILED=YES");
-        options.emplace_back("NUM_THREADS=ALL_CPUS");
+    if (driverOptions.empty()) {
+        options       = default_driver_options(driver);
         driverOptions = options;
     }
 
+    auto dataSet = driver.create_dataset<StorageType>(meta.rows, meta.cols, 1, filename, driverOptions);
+    dataSet.set_colortable(1, ct);
+    dataSet.write_geometadata(meta);
+
     for (auto& [key, value] : metadataValues) {
-        memDataSet.set_metadata(key, value);
+        dataSet.set_metadata(key, value);
     }
 
-    driver.create_dataset_copy(memDataSet, filename, driverOptions);
+    // Strips of roughly one million cells, consisting of complete block rows
+    // so every block is written once and can be compressed and flushed immediately
+    const auto blockRows = std::max(1, dataSet.rasterband(1).block_size().height);
+    const auto cols      = std::max(1, meta.cols);
+    const auto stripRows = std::min(meta.rows, blockRows * std::max(1, (1 << 20) / (blockRows * cols)));
+
+    std::vector<StorageType> converted(size_t(stripRows) * meta.cols);
+    for (int32_t row = 0; row < meta.rows; row += stripRows) {
+        const auto rows = std::min(stripRows, meta.rows - row);
+        auto stripData  = data.subspan(size_t(row) * meta.cols, size_t(rows) * meta.cols);
+        GDALCopyWords(stripData.data(), TypeResolve<RasterDataType>::value, sizeof(RasterDataType), converted.data(), TypeResolve<StorageType>::value, sizeof(StorageType), truncate<int>(stripData.size()));
+        dataSet.write_rasterdata(1, 0, row, meta.cols, rows, converted.data(), meta.cols, rows);
+    }
 }
 
 template <typename RasterDataType>
@@ -115,19 +267,22 @@ void write_raster_data(
     const std::unordered_map<std::string, std::string>& metadataValues,
     const GDALColorTable* ct = nullptr)
 {
-    // To write a raster to disk we need a dataset that contains the data
-    // Create a memory dataset with 0 bands, then assign a band given the pointer of our vector
-    // Creating a dataset with 1 band would casuse unnecessary memory allocation
-    auto memDriver = gdal::RasterDriver::create(gdal::RasterType::Memory);
-    gdal::RasterDataSet memDataSet(memDriver.create_dataset<StorageType>(meta.rows, meta.cols, 0));
-
     if constexpr (std::is_same_v<StorageType, RasterDataType>) {
+        // To write a raster to disk we need a dataset that contains the data
+        // Create a memory dataset with 0 bands, then assign a band given the pointer of our vector
+        // Creating a dataset with 1 band would casuse unnecessary memory allocation
+        auto memDriver = gdal::RasterDriver::create(gdal::RasterType::Memory);
+        gdal::RasterDataSet memDataSet(memDriver.create_dataset<StorageType>(meta.rows, meta.cols, 0));
         write_raster_dataset(data, memDataSet, meta, filename, driverOptions, metadataValues, ct);
     } else {
-        // TODO: Investigate VRT driver to create a virtual dataset with different type without creating a copy
-        std::vector<StorageType> converted(data.size());
-        std::transform(data.begin(), data.end(), converted.begin(), [](RasterDataType d) { return static_cast<StorageType>(d); });
-        write_raster_dataset<StorageType>(converted, memDataSet, meta, filename, driverOptions, metadataValues, ct);
+        if (auto driver = gdal::RasterDriver::create(filename); driver.supports_create()) {
+            write_raster_dataset_converted<StorageType>(data, driver, meta, filename, driverOptions, metadataValues, ct);
+            return;
+        }
+
+        // The driver only supports create_dataset_copy, copy from a view that converts the data while it is being copied
+        auto view = create_raster_view<StorageType>(data, meta);
+        write_dataset_copy(view.dataset(), meta, filename, driverOptions, metadataValues, ct);
     }
 }
 
@@ -234,6 +389,23 @@ gdal::RasterDataSet create_memory_dataset(std::span<const T> rasterData, const G
     return srcDataSet;
 }
 
+namespace detail {
+
+// The type pairs that have a vectorized implementation in simdcast.h
+template <typename TSource, typename TDest>
+constexpr bool has_simd_cast =
+    (std::is_same_v<TSource, float> && (std::is_same_v<TDest, double> || std::is_same_v<TDest, int32_t> || std::is_same_v<TDest, uint8_t>)) ||
+    (std::is_same_v<TDest, float> && (std::is_same_v<TSource, double> || std::is_same_v<TSource, int32_t> || std::is_same_v<TSource, uint8_t>));
+
+// Checks if the value can be represented in the type without loss
+template <typename T>
+bool is_exact_value(double value) noexcept
+{
+    return inf::fits_in_type<T>(value) && static_cast<double>(static_cast<T>(value)) == value;
+}
+
+}
+
 template <typename TSource, typename TDest>
 GeoMetadata cast_raster(const GeoMetadata& meta, std::span<const TSource> srcData, std::span<TDest> dstData)
 {
@@ -256,6 +428,17 @@ GeoMetadata cast_raster(const GeoMetadata& meta, std::span<const TSource> srcDat
     if constexpr (!srcHasNaN && dstHasNaN) {
         if (meta.nodata) {
             auto nodata = *meta.nodata;
+            if constexpr (has_simd_cast<TSource, TDest>) {
+                if (!std::isnan(nodata) && is_exact_value<TSource>(nodata)) {
+                    simd::cast_nodata_to_nan(srcData, static_cast<TSource>(nodata), dstData);
+                } else {
+                    // no source value can be equal to the nodata
+                    simd::cast(srcData, dstData);
+                }
+
+                return resultMeta;
+            }
+
             // nodata values will be replaced with nan
             for (int32_t i = 0; i < srcData.size(); ++i) {
                 if (srcData[i] == nodata) {
@@ -270,6 +453,17 @@ GeoMetadata cast_raster(const GeoMetadata& meta, std::span<const TSource> srcDat
     } else if constexpr (srcHasNaN && !dstHasNaN) {
         if (resultMeta.nodata) {
             auto nodata = static_cast<TDest>(*resultMeta.nodata);
+            if constexpr (has_simd_cast<TSource, TDest>) {
+                // a NaN source nodata only matches the NaN values, which are replaced anyway
+                auto srcNodata = std::numeric_limits<float>::quiet_NaN();
+                if (!std::isnan(*meta.nodata) && is_exact_value<float>(*meta.nodata)) {
+                    srcNodata = static_cast<float>(*meta.nodata);
+                }
+
+                simd::cast_nan_to_nodata(srcData, srcNodata, nodata, dstData);
+                return resultMeta;
+            }
+
             // nan values need to be replaced with the nodata value
             for (size_t i = 0; i < srcData.size(); ++i) {
                 if (std::isnan(srcData[i]) || srcData[i] == meta.nodata) {
@@ -284,6 +478,11 @@ GeoMetadata cast_raster(const GeoMetadata& meta, std::span<const TSource> srcDat
     }
 
     // No nodata conversions, regular copy
+    if constexpr (has_simd_cast<TSource, TDest>) {
+        simd::cast(srcData, dstData);
+        return resultMeta;
+    }
+
     for (size_t i = 0; i < srcData.size(); ++i) {
         dstData[i] = static_cast<TDest>(srcData[i]);
     }
@@ -291,24 +490,58 @@ GeoMetadata cast_raster(const GeoMetadata& meta, std::span<const TSource> srcDat
     return resultMeta;
 }
 
-/*! The provided extent will be the extent of the resulting raster
- * Areas outside the extent of the raster on disk will be filled with nodata
+namespace detail {
+
+/*! Returns a buffer of at least size elements that is reused by subsequent calls on the same thread
+ * The contents are unspecified, the buffer remains valid until the next call on the same thread
  */
 template <typename T>
-GeoMetadata data_from_dataset(const gdal::RasterDataSet& dataSet, const GeoMetadata& extent, int bandNr, std::span<T> dstData)
+std::span<T> thread_scratch_buffer(size_t size)
 {
-    using namespace detail;
+    thread_local std::vector<T> buffer;
+    if (buffer.size() < size) {
+        buffer.resize(size);
+    }
 
-    auto meta   = dataSet.geometadata(bandNr);
-    auto cutOut = intersect_metadata(meta, extent);
+    return std::span<T>(buffer.data(), size);
+}
 
-    bool cutOutSmallerThenExtent = (extent.rows * extent.cols) != (cutOut.rows * cutOut.cols);
-    auto dstMeta                 = extent;
-    if (meta.nodata.has_value()) {
-        dstMeta.nodata = meta.nodata;
+// Target number of cells in the strips of the read and convert pipeline (4MiB of float data)
+inline constexpr size_t s_conversionStripCells = 1024 * 1024;
+
+/*! Reads the window as float in strips and converts each strip to T, only a single strip is kept in memory
+ * Used for byte rasters with a nodata value that does not fit in a byte
+ */
+template <typename T, typename WindowReader>
+GeoMetadata read_window_converted(const GeoMetadata& dstMeta, std::span<T> dstData, WindowReader& read)
+{
+    const auto cols      = std::max(1, dstMeta.cols);
+    const auto stripRows = std::clamp(truncate<int32_t>(s_conversionStripCells / cols), 1, std::max(1, dstMeta.rows));
+    auto scratch         = thread_scratch_buffer<float>(size_t(stripRows) * cols);
+
+    auto resultMeta = dstMeta;
+    for (int32_t row = 0; row < dstMeta.rows; row += stripRows) {
+        const auto rows  = std::min(stripRows, dstMeta.rows - row);
+        const auto cells = size_t(rows) * dstMeta.cols;
+
+        auto strip = scratch.subspan(0, cells);
+        std::fill(strip.begin(), strip.end(), static_cast<float>(dstMeta.nodata.value_or(0)));
+        read(strip.data(), row, rows);
+        resultMeta = cast_raster<float, T>(dstMeta, std::span<const float>(strip), dstData.subspan(size_t(row) * dstMeta.cols, cells));
     }
 
-    if (cutOutSmallerThenExtent && !dstMeta.nodata.has_value()) {
+    return resultMeta;
+}
+
+/*! Reads a window of the band into dstData which has the layout of dstMeta, the window is read by calling read(U* data, int32_t row, int32_t rows)
+ * which has to read the destination rows [row, row + rows) of the window in a buffer of rows * dstMeta.cols cells (U is T or float)
+ * When the window does not cover the full extent, the other cells are filled with nodata.
+ * The returned metadata contains the nodata of the resulting data
+ */
+template <typename T, typename WindowReader>
+GeoMetadata read_window(const gdal::RasterDataSet& dataSet, int bandNr, bool windowSmallerThenExtent, GeoMetadata dstMeta, std::span<T> dstData, WindowReader&& read)
+{
+    if (windowSmallerThenExtent && !dstMeta.nodata.has_value()) {
         dstMeta.nodata = static_cast<double>(std::numeric_limits<T>::max());
     }
 
@@ -316,17 +549,16 @@ GeoMetadata data_from_dataset(const gdal::RasterDataSet& dataSet, const GeoMetad
         throw InvalidArgument("Invalid data buffer provided: incorrect size");
     }
 
-    if (cutOutSmallerThenExtent && dstMeta.nodata.has_value()) {
-        std::fill(dstData.begin(), dstData.end(), static_cast<T>(dstMeta.nodata.value()));
-    }
-
     bool isByte = std::is_same_v<T, uint8_t>;
     if (isByte && dstMeta.nodata.has_value() && !inf::fits_in_type<T>(dstMeta.nodata.value())) {
-        std::vector<float> tempData(extent.rows * extent.cols, static_cast<float>(dstMeta.nodata.value_or(0)));
-        read_raster_data(bandNr, cutOut, dataSet, tempData.data(), extent.cols);
-        dstMeta = cast_raster<float, T>(dstMeta, tempData, dstData);
+        // every cell is written by the conversion, no need to fill the data with nodata
+        dstMeta = read_window_converted(dstMeta, dstData, read);
     } else {
-        read_raster_data(bandNr, cutOut, dataSet, dstData.data(), dstMeta.cols);
+        if (windowSmallerThenExtent && dstMeta.nodata.has_value()) {
+            std::fill(dstData.begin(), dstData.end(), static_cast<T>(dstMeta.nodata.value()));
+        }
+
+        read(dstData.data(), 0, dstMeta.rows);
 
         if (typeid(T()) != dataSet.band_datatype(bandNr)) {
             // perform nodata sanity checks
@@ -342,6 +574,73 @@ GeoMetadata data_from_dataset(const gdal::RasterDataSet& dataSet, const GeoMetad
     return dstMeta;
 }
 
+/*! The part of the cut out that covers the destination rows [row, row + rows), relative to row */
+inline CutOut cutout_rows(const CutOut& cutOut, int32_t row, int32_t rows)
+{
+    const auto begin = std::max(cutOut.dstRowOffset, row);
+    const auto end   = std::min(cutOut.dstRowOffset + cutOut.rows, row + rows);
+
+    auto result         = cutOut;
+    result.srcRowOffset = std::max(0, cutOut.srcRowOffset) + (begin - cutOut.dstRowOffset);
+    result.dstRowOffset = begin - row;
+    result.rows         = std::max(0, end - begin);
+    return result;
+}
+
+/*! The part of the resampled window that covers the destination rows [row, row + rows), relative to row */
+inline ResampledWindow resampled_window_rows(const ResampledWindow& window, int32_t row, int32_t rows)
+{
+    const auto begin = std::max(window.dstRowOffset, row);
+    const auto end   = std::min(window.dstRowOffset + window.rows, row + rows);
+
+    auto result         = window;
+    result.dstRowOffset = begin - row;
+    result.rows         = std::max(0, end - begin);
+    if (result.rows == window.rows || window.rows == 0) {
+        return result;
+    }
+
+    const auto scaleY   = window.srcRows / window.rows;
+    result.srcRowOffset = window.srcRowOffset + (begin - window.dstRowOffset) * scaleY;
+    result.srcRows      = std::min(window.srcRowOffset + window.srcRows, result.srcRowOffset + result.rows * scaleY) - result.srcRowOffset;
+    return result;
+}
+
+/*! Reads the cut out of the band into dstData which has the layout of dstMeta
+ * Cells outside of the cut out are filled with nodata, the returned metadata contains the nodata of the resulting data
+ */
+template <typename T>
+GeoMetadata read_cutout(const gdal::RasterDataSet& dataSet, int bandNr, const CutOut& cutOut, GeoMetadata dstMeta, std::span<T> dstData)
+{
+    bool cutOutSmallerThenExtent = (dstMeta.rows * dstMeta.cols) != (cutOut.rows * cutOut.cols);
+    return read_window(dataSet, bandNr, cutOutSmallerThenExtent, dstMeta, dstData, [&](auto* data, int32_t row, int32_t rows) {
+        if (auto stripCutOut = cutout_rows(cutOut, row, rows); stripCutOut.rows > 0) {
+            read_raster_data(bandNr, stripCutOut, dataSet, data, dstMeta.cols);
+        }
+    });
+}
+
+}
+
+/*! The provided extent will be the extent of the resulting raster
+ * Areas outside the extent of the raster on disk will be filled with nodata
+ */
+template <typename T>
+GeoMetadata data_from_dataset(const gdal::RasterDataSet& dataSet, const GeoMetadata& extent, int bandNr, std::span<T> dstData)
+{
+    using namespace detail;
+
+    auto meta   = dataSet.geometadata(bandNr);
+    auto cutOut = intersect_metadata(meta, extent);
+
+    auto dstMeta = extent;
+    if (meta.nodata.has_value()) {
+        dstMeta.nodata = meta.nodata;
+    }
+
+    return read_cutout(dataSet, bandNr, cutOut, dstMeta, dstData);
+}
+
 /* This version will read the full dataset and is used in cases where there is no geotransform info available */
 template <typename T>
 GeoMetadata data_from_dataset(const gdal::RasterDataSet& dataSet, int bandNr, std::span<T> dstData)
@@ -363,9 +662,11 @@ GeoMetadata data_from_dataset(const gdal::RasterDataSet& dataSet, int bandNr, st
 
     bool isByte = std::is_same_v<T, uint8_t>;
     if (isByte && meta.nodata.has_value() && !inf::fits_in_type<T>(meta.nodata.value())) {
-        std::vector<float> tempData(meta.rows * meta.cols, static_cast<float>(meta.nodata.value_or(0)));
-        read_raster_data(bandNr, cutOut, dataSet, tempData.data(), meta.cols);
-        meta = cast_raster<float, T>(meta, tempData, dstData);
+        auto read = [&](float* data, int32_t row, int32_t rows) {
+            read_raster_data(bandNr, cutout_rows(cutOut, row, rows), dataSet, data, meta.cols);
+        };
+
+        meta = read_window_converted(meta, dstData, read);
     } else {
         read_raster_data(bandNr, cutOut, dataSet, dstData.data(), meta.cols);
     }
@@ -401,6 +702,266 @@ GeoMetadata read_raster_data(gdal::RasterDataSet& dataSet, const GeoMetadata& ex
     return read_raster_data<T>(dataSet, extent, 1, dstData);
 }
 
+/*! Reads the extent of the raster band, the cell size of the extent can differ from the cell size of the raster
+ * When the cell size is coarser, the coarsest overview that still has the requested resolution is used
+ * so only a fraction of the data is read. The values are resampled using the resample algorithm
+ * (NearestNeighbour, Bilinear, Cubic, CubicSpline, Lanczos, Average, Mode or RootMeanSquare)
+ * Areas outside the extent of the raster on disk will be filled with nodata
+ */
+template <typename T>
+GeoMetadata read_raster_data_resampled(const gdal::RasterDataSet& dataSet, const GeoMetadata& extent, int bandNr, std::span<T> dstData, ResampleAlgorithm algorithm = ResampleAlgorithm::NearestNeighbour)
+{
+    using namespace detail;
+
+    auto meta = dataSet.geometadata(bandNr);
+    if (math::approx_equal(meta.cellSize.x, extent.cellSize.x, 1e-10) && math::approx_equal(meta.cellSize.y, extent.cellSize.y, 1e-10)) {
+        return data_from_dataset(dataSet, extent, bandNr, dstData);
+    }
+
+    auto window = intersect_metadata_resampled(meta, extent);
+
+    auto dstMeta = extent;
+    if (meta.nodata.has_value()) {
+        dstMeta.nodata = meta.nodata;
+    }
+
+    bool windowSmallerThenExtent = (dstMeta.rows * dstMeta.cols) != (window.rows * window.cols);
+    return read_window(dataSet, bandNr, windowSmallerThenExtent, dstMeta, dstData, [&](auto* data, int32_t row, int32_t rows) {
+        using ValueType = std::remove_pointer_t<decltype(data)>;
+        detail::read_raster_data_resampled(bandNr, resampled_window_rows(window, row, rows), algorithm, dataSet, typeid(ValueType), data, dstMeta.cols);
+    });
+}
+
+template <typename T>
+GeoMetadata read_raster_data_resampled(const gdal::RasterDataSet& dataSet, const GeoMetadata& extent, std::span<T> dstData, ResampleAlgorithm algorithm = ResampleAlgorithm::NearestNeighbour)
+{
+    return read_raster_data_resampled<T>(dataSet, extent, 1, dstData, algorithm);
+}
+
+namespace detail {
+
+// A rectangle of the band that is read with a single RasterIO call for one or more extents of a batch read
+struct BatchReadGroup
+{
+    int32_t colOffset = 0;
+    int32_t rowOffset = 0;
+    int32_t cols      = 0;
+    int32_t rows      = 0;
+    std::vector<size_t> members; // the indexes of the cut outs that are covered by the group
+};
+
+// Maximum number of cells of a batch read group, this limits the size of the buffer a group is read into
+inline constexpr int64_t s_batchReadGroupMaxCells = 4 * 1024 * 1024;
+
+/*! Clusters the cut outs per block of the band, cut outs whose block ranges overlap or touch are merged
+ * as long as the merged block range is not larger than the separate block ranges combined
+ * Cut outs that do not intersect the band are not part of any group
+ */
+std::vector<BatchReadGroup> group_cutouts(std::span<const CutOut> cutOuts, Size blockSize, int64_t maxCells = s_batchReadGroupMaxCells);
+
+}
+
+/*! Reads many (small, possibly overlapping) extents of the band, the result for every extent is identical to read_raster_data with that extent
+ * The extents are grouped per block of the band, the groups are read with a single RasterIO call each and scattered into the
+ * buffers of the extents, so blocks that are shared by several extents are only read and decompressed once.
+ * dstData: a buffer for every extent with the size of that extent
+ * Returns the metadata of the resulting data of every extent
+ */
+template <typename T>
+std::vector<GeoMetadata> read_raster_data_batch(const gdal::RasterDataSet& dataSet, std::span<const GeoMetadata> extents, int bandNr, std::span<const std::span<T>> dstData)
+{
+    using namespace detail;
+
+    if (extents.size() != dstData.size()) {
+        throw InvalidArgument("The number of extents does not match the number of buffers ({} <-> {})", extents.size(), dstData.size());
+    }
+
+    auto meta = dataSet.geometadata(bandNr);
+
+    std::vector<CutOut> cutOuts;
+    cutOuts.reserve(extents.size());
+    for (size_t i = 0; i < extents.size(); ++i) {
+        if (truncate<int32_t>(dstData[i].size()) != extents[i].rows * extents[i].cols) {
+            throw InvalidArgument("Invalid data buffer provided: incorrect size");
+        }
+
+        cutOuts.push_back(intersect_metadata(meta, extents[i]));
+    }
+
+    // byte data with a nodata value that does not fit in a byte is converted from float (see read_window)
+    const bool readAsFloat = std::is_same_v<T, uint8_t> && meta.nodata.has_value() && !inf::fits_in_type<T>(*meta.nodata);
+
+    std::vector<T> groupData;
+    std::vector<float> groupFloatData;
+
+    std::vector<GeoMetadata> result(extents.size());
+    std::vector<bool> processed(extents.size(), false);
+
+    auto readExtent = [&](size_t index, const BatchReadGroup* group) {
+        auto& cutOut = cutOuts[index];
+
+        auto dstMeta = extents[index];
+        if (meta.nodata.has_value()) {
+            dstMeta.nodata = meta.nodata;
+        }
+
+        bool cutOutSmallerThenExtent = (dstMeta.rows * dstMeta.cols) != (cutOut.rows * cutOut.cols);
+        result[index] = read_window(dataSet, bandNr, cutOutSmallerThenExtent, dstMeta, dstData[index], [&](auto* data, int32_t row, int32_t rows) {
+            using ValueType = std::remove_pointer_t<decltype(data)>;
+
+            auto stripCutOut = cutout_rows(cutOut, row, rows);
+            if (group == nullptr || stripCutOut.rows <= 0 || stripCutOut.cols <= 0) {
+                return;
+            }
+
+            const ValueType* groupBuffer = nullptr;
+            if constexpr (std::is_same_v<ValueType, T>) {
+                groupBuffer = groupData.data();
+            } else {
+                groupBuffer = groupFloatData.data();
+            }
+
+            const auto srcCol = std::max(0, stripCutOut.srcColOffset) - group->colOffset;
+            for (int32_t r = 0; r < stripCutOut.rows; ++r) {
+                const auto srcRow = stripCutOut.srcRowOffset + r - group->rowOffset;
+                auto* src         = groupBuffer + size_t(srcRow) * group->cols + srcCol;
+                std::copy_n(src, stripCutOut.cols, data + size_t(stripCutOut.dstRowOffset + r) * dstMeta.cols + stripCutOut.dstColOffset);
+            }
+        });
+
+        processed[index] = true;
+    };
+
+    for (auto& group : group_cutouts(cutOuts, dataSet.rasterband(bandNr).block_size())) {
+        const auto cells = size_t(group.rows) * size_t(group.cols);
+        if (readAsFloat) {
+            groupFloatData.resize(cells);
+            dataSet.read_rasterdata<float>(bandNr, group.colOffset, group.rowOffset, group.cols, group.rows, groupFloatData.data(), group.cols, group.rows);
+        } else {
+            groupData.resize(cells);
+            dataSet.read_rasterdata<T>(bandNr, group.colOffset, group.rowOffset, group.cols, group.rows, groupData.data(), group.cols, group.rows);
+        }
+
+        for (auto index : group.members) {
+            readExtent(index, &group);
+        }
+    }
+
+    // the extents that do not intersect the raster only contain nodata
+    for (size_t i = 0; i < extents.size(); ++i) {
+        if (!processed[i]) {
+            readExtent(i, nullptr);
+        }
+    }
+
+    return result;
+}
+
+template <typename T>
+std::vector<GeoMetadata> read_raster_data_batch(const gdal::RasterDataSet& dataSet, std::span<const GeoMetadata> extents, std::span<const std::span<T>> dstData)
+{
+    return read_raster_data_batch<T>(dataSet, extents, 1, dstData);
+}
+
+struct ParallelReadOptions
+{
+    uint32_t threadCount     = 0; //! number of reader threads, 0 uses all available cores
+    int32_t minimumStripRows = 0; //! minimum number of rows read in one call, rounded up to a multiple of the block height of the band
+    std::vector<std::string> driverOptions;
+};
+
+/*! Reads the extent of the raster band using multiple threads
+ * GDAL dataset handles cannot be shared between threads, so every reader thread opens its own handle.
+ * The extent is split in horizontal strips that are aligned to the blocks of the band, so no block is decoded twice.
+ * The result is identical to read_raster_data with the same extent
+ */
+template <typename T>
+GeoMetadata read_raster_data_parallel(const fs::path& filePath, const GeoMetadata& extent, int bandNr, std::span<T> dstData, const ParallelReadOptions& options = {})
+{
+    using namespace detail;
+
+    auto dataSet = RasterDataSet::open(filePath, options.driverOptions);
+    auto meta    = dataSet.geometadata(bandNr);
+    auto cutOut  = intersect_metadata(meta, extent);
+
+    auto dstMeta = extent;
+    if (meta.nodata.has_value()) {
+        dstMeta.nodata = meta.nodata;
+    }
+
+    bool cutOutSmallerThenExtent = (dstMeta.rows * dstMeta.cols) != (cutOut.rows * cutOut.cols);
+    if (cutOutSmallerThenExtent && !dstMeta.nodata.has_value()) {
+        dstMeta.nodata = static_cast<double>(std::numeric_limits<T>::max());
+    }
+
+    if (truncate<int32_t>(dstData.size()) != dstMeta.rows * dstMeta.cols) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    const auto blockRows = std::max(1, dataSet.rasterband(bandNr).block_size().height);
+    auto stripRows       = std::max(options.minimumStripRows, blockRows);
+    stripRows            = ((stripRows + blockRows - 1) / blockRows) * blockRows;
+
+    // strip boundaries are multiples of the strip size in raster row space
+    const auto srcFirstRow = std::max(0, cutOut.srcRowOffset);
+    const auto srcEndRow   = srcFirstRow + cutOut.rows;
+    std::vector<std::pair<int32_t, int32_t>> strips; // first row, row count
+    for (auto row = srcFirstRow; row < srcEndRow;) {
+        auto stripEnd = std::min(srcEndRow, (row / stripRows + 1) * stripRows);
+        strips.emplace_back(row, stripEnd - row);
+        row = stripEnd;
+    }
+
+    if (strips.size() <= 1 || options.threadCount == 1) {
+        return read_cutout(dataSet, bandNr, cutOut, dstMeta, dstData);
+    }
+
+    const auto dstFirstRow = std::max(0, cutOut.dstRowOffset);
+    std::optional<double> resultNodata;
+
+    parallel_for(
+        truncate<int64_t>(strips.size()), options.threadCount,
+        [&]() { return RasterDataSet::open(filePath, options.driverOptions); },
+        [&](RasterDataSet& ds, int64_t index) {
+            auto [firstRow, rows] = strips[index];
+
+            CutOut stripCutOut       = cutOut;
+            stripCutOut.srcRowOffset = firstRow;
+            stripCutOut.dstRowOffset = 0;
+            stripCutOut.rows         = rows;
+
+            auto stripMeta = dstMeta;
+            stripMeta.rows = rows;
+
+            auto stripData  = dstData.subspan(size_t(dstFirstRow + firstRow - srcFirstRow) * dstMeta.cols, size_t(rows) * dstMeta.cols);
+            auto resultMeta  = read_cutout(ds, bandNr, stripCutOut, stripMeta, stripData);
+            if (index == 0) {
+                // the nodata handling only depends on the band and the requested nodata, so it is the same for every strip
+                resultNodata = resultMeta.nodata;
+            }
+        });
+
+    dstMeta.nodata = resultNodata;
+    if (cutOutSmallerThenExtent && dstMeta.nodata.has_value()) {
+        // fill the rows that are not covered by the raster
+        const auto nodata = static_cast<T>(*dstMeta.nodata);
+        std::fill(dstData.begin(), dstData.begin() + size_t(dstFirstRow) * dstMeta.cols, nodata);
+        std::fill(dstData.begin() + size_t(dstFirstRow + cutOut.rows) * dstMeta.cols, dstData.end(), nodata);
+    }
+
+    return dstMeta;
+}
+
+template <typename T>
+GeoMetadata read_raster_data_parallel(const fs::path& filePath, int bandNr, std::span<T> dstData, const ParallelReadOptions& options = {})
+{
+    return read_raster_data_parallel<T>(filePath, read_metadata(filePath, options.driverOptions), bandNr, dstData, options);
+}
+
+/*! Writes the raster data to disk using StorageType as data type of the raster band
+ * The values are converted by gdal (GDALCopyWords): values are rounded to the nearest integer and clamped to the range
+ * of an integral storage type and NaN becomes 0. Note that this differs from a static_cast, which truncates.
+ */
 template <typename StorageType, class RasterType>
 void write_raster_as(std::span<const RasterType> rasterData, const GeoMetadata& meta, const fs::path& filename, std::span<const std::string> driverOptions = {}, const std::unordered_map<std::string, std::string>& metadataValues = {})
 {
@@ -430,6 +991,7 @@ void write_raster(std::span<const T> rasterData, const GeoMetadata& meta, inf::g
     detail::write_raster_to_dataset_band<T>(ds, bandNr, rasterData, meta);
 }
 
+/*! Writes the raster data to disk using storageType as data type of the raster band, the values are converted as in write_raster_as */
 template <class T>
 void write_raster(std::span<const T> rasterData, const GeoMetadata& meta, const fs::path& filename, const std::type_info& storageType, std::span<const std::string> driverOptions = {}, const std::unordered_map<std::string, std::string>& metadataValues = {})
 {
@@ -481,4 +1043,142 @@ void write_raster_color_mapped(std::span<const T> data, const GeoMetadata& meta,
     detail::write_raster_data<T>(data, meta, filename, driverOptions, {}, &ct);
 }
 
+enum class TiffCompression
+{
+    None,
+    Lzw,
+    Deflate,
+    Zstd,
+};
+
+struct TiledWriteOptions
+{
+    TiffCompression compression = TiffCompression::Deflate;
+    int32_t compressionLevel    = 0;    //! compression level of the codec (DEFLATE: 1-12, ZSTD: 1-22), 0 uses the codec default
+    bool predictor              = true; //! horizontal differencing for integer data, floating point prediction for floating point data
+    int32_t tileSize            = 256;  //! width and height of the tiles, must be a multiple of 16
+    uint32_t threadCount        = 0;    //! number of compression threads, 0 uses all available cores
+    std::vector<std::string> driverOptions; //! additional GeoTIFF creation options
+};
+
+namespace detail {
+
+std::vector<std::string> tiled_geotiff_options(const TiledWriteOptions& options, const std::type_info& storageType);
+
+}
+
+/*! Writes the raster as a tiled GeoTIFF, compressing the tiles on multiple threads
+ * The data is written in strips of complete tile rows that contain enough tiles to keep all the threads busy,
+ * when a strip is flushed the tiles are compressed in parallel and written in order.
+ * Conversion to the storage type is performed per strip, also on multiple threads.
+ * The values are rounded and clamped to the storage type by gdal, the same conversion as write_raster.
+ */
+template <typename StorageType, typename T>
+void write_raster_tiled(std::span<const T> data, const GeoMetadata& meta, const fs::path& filename, const TiledWriteOptions& options = {})
+{
+    if (truncate<int32_t>(data.size()) != meta.rows * meta.cols) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    if constexpr (std::is_unsigned_v<StorageType>) {
+        if (meta.nodata.has_value() && meta.nodata.value() < 0) {
+            throw RuntimeError("Trying to store a raster with unsigned data type using negative nodata value");
+        }
+    }
+
+    detail::create_output_directory_if_needed(filename);
+
+    const auto creationOptions = detail::tiled_geotiff_options(options, typeid(StorageType));
+    auto driver                = gdal::RasterDriver::create(gdal::RasterType::GeoTiff);
+    auto dataSet               = driver.create_dataset<StorageType>(meta.rows, meta.cols, 1, filename, creationOptions);
+    dataSet.write_geometadata(meta);
+
+    const auto threadCount = options.threadCount == 0 ? default_thread_count() : options.threadCount;
+    const auto tilesPerRow = std::max(1, (meta.cols + options.tileSize - 1) / options.tileSize);
+    const auto tileRows    = std::max(1, truncate<int32_t>((2 * threadCount + tilesPerRow - 1) / tilesPerRow));
+    const auto stripRows   = std::max(1, std::min(meta.rows, tileRows * options.tileSize));
+
+    std::vector<StorageType> converted;
+    if constexpr (!std::is_same_v<StorageType, T>) {
+        converted.resize(size_t(stripRows) * meta.cols);
+    }
+
+    for (int32_t row = 0; row < meta.rows; row += stripRows) {
+        const auto rows = std::min(stripRows, meta.rows - row);
+        auto stripData  = data.subspan(size_t(row) * meta.cols, size_t(rows) * meta.cols);
+
+        if constexpr (std::is_same_v<StorageType, T>) {
+            dataSet.write_rasterdata(1, 0, row, meta.cols, rows, stripData.data(), meta.cols, rows);
+        } else {
+            parallel_for(rows, threadCount, [&](int64_t stripRow) {
+                const auto offset = size_t(stripRow) * meta.cols;
+                GDALCopyWords(stripData.data() + offset, TypeResolve<T>::value, sizeof(T), converted.data() + offset, TypeResolve<StorageType>::value, sizeof(StorageType), meta.cols);
+            });
+
+            dataSet.write_rasterdata(1, 0, row, meta.cols, rows, converted.data(), meta.cols, rows);
+        }
+
+        // the strip consists of complete tiles, flushing them submits the tiles to the compression threads
+        dataSet.flush_cache();
+    }
+}
+
+template <typename T>
+void write_raster_tiled(std::span<const T> data, const GeoMetadata& meta, const fs::path& filename, const TiledWriteOptions& options = {})
+{
+    write_raster_tiled<T, T>(data, meta, filename, options);
+}
+
+struct CogWriteOptions
+{
+    TiffCompression compression          = TiffCompression::Deflate;
+    int32_t compressionLevel             = 0;    //! compression level of the codec, 0 uses the codec default
+    bool predictor                       = true; //! use the predictor that matches the data type
+    int32_t tileSize                     = 512;  //! width and height of the tiles, must be a multiple of 16
+    ResampleAlgorithm overviewResampling = ResampleAlgorithm::Average;
+    uint32_t threadCount                 = 0; //! number of threads for the overview generation and compression, 0 uses all available cores
+    std::vector<std::string> driverOptions;   //! additional COG creation options
+};
+
+namespace detail {
+
+/*! Builds the overview pyramid of the in memory dataset and writes it as a cloud optimized GeoTIFF with the storage type
+ * When the storage type differs, the dataset and its overviews are converted by a raster view while they are copied
+ */
+void write_cog(gdal::RasterDataSet memDataSet, const GeoMetadata& meta, const std::type_info& storageType, const fs::path& filename, const CogWriteOptions& options);
+
+}
+
+/*! Writes the raster as a cloud optimized GeoTIFF in a single pass
+ * The overviews are generated in memory on multiple threads until the smallest overview fits in a single tile.
+ * The full resolution data and the overviews are then written as a tiled file with the overviews located
+ * before the full resolution data, as expected by COG readers.
+ * The values are rounded and clamped to the storage type by gdal, the same conversion as write_raster.
+ * The overviews are computed from the source values and converted in the same way.
+ */
+template <typename StorageType, typename T>
+void write_raster_cog(std::span<const T> data, const GeoMetadata& meta, const fs::path& filename, const CogWriteOptions& options = {})
+{
+    if (truncate<int32_t>(data.size()) != meta.rows * meta.cols) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    if constexpr (std::is_unsigned_v<StorageType>) {
+        if (meta.nodata.has_value() && meta.nodata.value() < 0) {
+            throw RuntimeError("Trying to store a raster with unsigned data type using negative nodata value");
+        }
+    }
+
+    detail::create_output_directory_if_needed(filename);
+
+    // the COG driver only supports create_dataset_copy, a conversion is performed by a view so no converted copy of the raster is needed
+    detail::write_cog(create_memory_dataset(data, meta), meta, typeid(StorageType), filename, options);
+}
+
+template <typename T>
+void write_raster_cog(std::span<const T> data, const GeoMetadata& meta, const fs::path& filename, const CogWriteOptions& options = {})
+{
+    write_raster_cog<T, T>(data, meta, filename, options);
+}
+
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "infra/filesystem.h"
+#include "infra/gdal.h"
+#include "infra/gdalio.h"
+#include "infra/geometadata.h"
+#include "infra/span.h"
+
+#include <cpl_virtualmem.h>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace inf::gdal {
+
+namespace detail {
+
+struct VirtualMemDeleter
+{
+    void operator()(CPLVirtualMem* mem) const noexcept;
+};
+
+using VirtualMemPtr = std::unique_ptr<CPLVirtualMem, VirtualMemDeleter>;
+
+/*! Maps the file contents of the raster band in memory
+ * Returns nullptr when the band can not be exposed as a contiguous array of the requested type:
+ * compressed or tiled data, interleaved bands, a different data type or a non native byte order.
+ */
+VirtualMemPtr map_raster_band(RasterDataSet& dataSet, int bandNr, const std::type_info& type);
+
+}
+
+/*! Read only view on the data of a raster band
+ * When the band is stored uncompressed and contiguously on disk with the requested type (e.g. ENVI, EHdr or
+ * an uncompressed stripped GeoTIFF) the file is memory mapped and the data is exposed without copying it.
+ * Otherwise the band is read in memory using the regular read path.
+ * The data remains valid for the lifetime of the MappedRaster.
+ */
+template <typename T>
+class MappedRaster
+{
+public:
+    static MappedRaster open(const fs::path& filePath, int bandNr = 1, const std::vector<std::string>& driverOpts = {})
+    {
+        return MappedRaster(RasterDataSet::open(filePath, driverOpts), bandNr);
+    }
+
+    explicit MappedRaster(RasterDataSet dataSet, int bandNr = 1)
+    : _dataSet(std::move(dataSet))
+    {
+        if (_dataSet.has_valid_geotransform()) {
+            _meta = _dataSet.geometadata(bandNr);
+        } else {
+            _meta.nodata = _dataSet.nodata_value(bandNr);
+            _meta.rows   = _dataSet.y_size();
+            _meta.cols   = _dataSet.x_size();
+        }
+
+        // byte rasters with a nodata value that does not fit in the type are converted when reading, this can not be done in place
+        const bool needsConversion = std::is_same_v<T, uint8_t> && _meta.nodata.has_value() && !inf::fits_in_type<T>(*_meta.nodata);
+        if (!needsConversion) {
+            _mapping = detail::map_raster_band(_dataSet, bandNr, typeid(T));
+        }
+
+        const auto size = size_t(_meta.rows) * size_t(_meta.cols);
+        if (_mapping) {
+            _data = std::span<const T>(static_cast<const T*>(CPLVirtualMemGetAddr(_mapping.get())), size);
+        } else {
+            _fallbackData.resize(size);
+            _meta = io::read_raster_data<T>(_dataSet, bandNr, _fallbackData);
+            _data = _fallbackData;
+        }
+    }
+
+    MappedRaster(MappedRaster&&) noexcept = default;
+
+    MappedRaster& operator=(MappedRaster&& other) noexcept
+    {
+        if (this != &other) {
+            // the mapping has to be released before the dataset is closed
+            _mapping.reset();
+            _dataSet      = std::move(other._dataSet);
+            _mapping      = std::move(other._mapping);
+            _meta         = std::move(other._meta);
+            _fallbackData = std::move(other._fallbackData);
+            _data         = other._data;
+            other._data   = {};
+        }
+
+        return *this;
+    }
+
+    MappedRaster(const MappedRaster&)            = delete;
+    MappedRaster& operator=(const MappedRaster&) = delete;
+
+    /*! True when the data is served directly from the memory mapped file */
+    bool is_mapped() const noexcept
+    {
+        return _mapping != nullptr;
+    }
+
+    const GeoMetadata& metadata() const noexcept
+    {
+        return _meta;
+    }
+
+    std::span<const T> data() const noexcept
+    {
+        return _data;
+    }
+
+    std::span<const T> row(int32_t row) const noexcept
+    {
+        return _data.subspan(size_t(row) * size_t(_meta.cols), size_t(_meta.cols));
+    }
+
+private:
+    // Declared before the mapping, the mapping must be released before the dataset is closed
+    RasterDataSet _dataSet;
+    detail::VirtualMemPtr _mapping;
+    GeoMetadata _meta;
+    std::vector<T> _fallbackData;
+    std::span<const T> _data;
+};
+
+}
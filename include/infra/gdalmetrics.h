@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class GDALMajorObject;
+
+namespace inf::gdal {
+
+/*! The instrumented operations, warp, translate and rasterize are recorded for the source dataset
+ * with the size of the produced raster as amount of bytes */
+enum class IoOperation
+{
+    Read,
+    Write,
+    Warp,
+    Translate,
+    Rasterize,
+    EnumCount,
+};
+
+std::string_view io_operation_name(IoOperation op) noexcept;
+
+struct IoOperationMetrics
+{
+    uint64_t calls = 0;
+    uint64_t bytes = 0;                    //! raster data bytes read, written or produced by the operation
+    std::chrono::nanoseconds duration{0};  //! wall time spent in the operation
+    int64_t peakCacheUsage = 0;            //! highest GDAL block cache usage observed after the operation
+
+    void merge(const IoOperationMetrics& other) noexcept;
+};
+
+using IoOperationMetricsArray = std::array<IoOperationMetrics, size_t(IoOperation::EnumCount)>;
+
+struct DataSetIoMetrics
+{
+    std::string name; //! the description of the dataset (usually the path)
+    IoOperationMetricsArray operations;
+};
+
+/*! Opt-in registry of the raster I/O performed through the gdal wrappers
+ * Records call counts, bytes, wall time and block cache usage per dataset and per operation.
+ * Recording is disabled by default, the instrumented calls then only perform a single relaxed atomic load.
+ */
+class IoMetrics
+{
+public:
+    static IoMetrics& instance();
+
+    static bool enabled() noexcept
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    static void set_enabled(bool enabled) noexcept;
+
+    void record(IoOperation op, std::string_view dataSet, uint64_t bytes, std::chrono::nanoseconds duration);
+    void reset();
+
+    /*! The metrics per dataset, sorted on the dataset name */
+    std::vector<DataSetIoMetrics> datasets() const;
+    /*! The metrics per operation of all the datasets combined */
+    IoOperationMetricsArray totals() const;
+
+    std::string to_json() const;
+
+    /*! Logs the totals and the metrics per dataset, does nothing when logging support is not enabled */
+    void log() const;
+
+private:
+    static inline std::atomic<bool> s_enabled = false;
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, IoOperationMetricsArray> _metrics;
+};
+
+/*! Measures the wall time of an operation and records it in the metrics registry when enabled
+ * When recording is disabled, the construction and destruction is inlined and does not touch the dataset
+ */
+class IoMetricsScope
+{
+public:
+    IoMetricsScope(IoOperation op, const char* dataSet, uint64_t bytes = 0) noexcept
+    : _enabled(IoMetrics::enabled())
+    , _op(op)
+    , _dataSet(dataSet)
+    , _bytes(bytes)
+    {
+        if (_enabled) {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    /*! The description of the dataset (or band) is only retrieved when the operation is recorded */
+    IoMetricsScope(IoOperation op, const GDALMajorObject* dataSet, uint64_t bytes = 0) noexcept
+    : _enabled(IoMetrics::enabled())
+    , _op(op)
+    , _object(dataSet)
+    , _bytes(bytes)
+    {
+        if (_enabled) {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~IoMetricsScope() noexcept
+    {
+        if (_enabled) {
+            record();
+        }
+    }
+
+    IoMetricsScope(const IoMetricsScope&)            = delete;
+    IoMetricsScope& operator=(const IoMetricsScope&) = delete;
+
+    bool enabled() const noexcept
+    {
+        return _enabled;
+    }
+
+    /*! For operations that only know the amount of data when they are finished */
+    void set_bytes(uint64_t bytes) noexcept
+    {
+        _bytes = bytes;
+    }
+
+private:
+    void record() noexcept;
+
+    bool _enabled;
+    IoOperation _op;
+    const char* _dataSet           = nullptr;
+    const GDALMajorObject* _object = nullptr;
+    uint64_t _bytes;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}
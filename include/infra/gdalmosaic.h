@@ -0,0 +1,195 @@
+#pragma once
+
+#include "infra/cast.h"
+#include "infra/exception.h"
+#include "infra/filesystem.h"
+#include "infra/gdal.h"
+#include "infra/gdaldatasetcache.h"
+#include "infra/gdalio.h"
+#include "infra/geometadata.h"
+#include "infra/parallelfor.h"
+#include "infra/rasterstatistics.h"
+#include "infra/rect.h"
+#include "infra/span.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace inf::gdal {
+
+struct MosaicTile
+{
+    fs::path path;
+    GeoMetadata metadata;
+};
+
+struct MosaicReadOptions
+{
+    uint32_t threadCount = 0; //! number of reader threads, 0 uses all available cores
+};
+
+/*! A raster that consists of a (large) collection of tiles with the same cell size and projection
+ * The footprints of the tiles are kept in an R-tree (sort tile recursive bulk loaded) so reading an extent
+ * only opens the tiles that intersect it. The tiles are opened through the DataSetCache.
+ * The index can be stored on disk so the metadata of the tiles does not have to be read every time.
+ * When tiles overlap, the tile that comes last in the tile list takes precedence for the cells where it has data.
+ */
+class RasterMosaic
+{
+public:
+    RasterMosaic() = default;
+
+    /*! Builds the index from the metadata of the tiles, the metadata is read using multiple threads */
+    static RasterMosaic create(std::span<const fs::path> tilePaths, uint32_t threadCount = 0);
+    static RasterMosaic create(std::vector<MosaicTile> tiles);
+
+    /*! Loads an index that was stored using save, the tiles are not checked for modifications */
+    static RasterMosaic load(const fs::path& indexPath);
+    void save(const fs::path& indexPath) const;
+
+    std::span<const MosaicTile> tiles() const noexcept;
+
+    /*! The metadata of the full mosaic, the nodata value is the nodata value of the first tile */
+    const GeoMetadata& metadata() const noexcept;
+
+    /*! The indexes of the tiles that intersect the extent, in tile list order */
+    std::vector<size_t> intersecting_tiles(const Rect<double>& extent) const;
+
+    /*! Reads the extent from the intersecting tiles, the cell size of the extent must match the cell size of the mosaic
+     * Areas that are not covered by a tile will be filled with nodata (as in data_from_dataset)
+     * The nodata cells of a tile do not overwrite the data of the other tiles, cells without data in any of the tiles
+     * get the nodata value of the mosaic, also when the tiles have different nodata values.
+     * The rows of the extent are divided in strips that are read in parallel.
+     */
+    template <typename T>
+    GeoMetadata read(const GeoMetadata& extent, int bandNr, std::span<T> dstData, const MosaicReadOptions& options = {}) const;
+
+    template <typename T>
+    GeoMetadata read(const GeoMetadata& extent, std::span<T> dstData, const MosaicReadOptions& options = {}) const
+    {
+        return read<T>(extent, 1, dstData, options);
+    }
+
+private:
+    struct IndexNode
+    {
+        Rect<double> bbox;
+        uint32_t begin = 0; // range in _entries for leaf nodes, range in _nodes otherwise
+        uint32_t end   = 0;
+        bool leaf      = false;
+    };
+
+    // Number of entries per node of the R-tree
+    static constexpr size_t s_nodeCapacity = 16;
+
+    explicit RasterMosaic(std::vector<MosaicTile> tiles, GeoMetadata metadata);
+
+    void build_index();
+
+    struct TileCutOut
+    {
+        size_t tileIndex = 0;
+        io::detail::CutOut cutOut;
+    };
+
+    /*! The cut outs of the tiles that intersect the extent in tile list order
+     * covered: set to true when the cut outs cover the full extent
+     */
+    std::vector<TileCutOut> intersecting_cutouts(const GeoMetadata& extent, bool& covered) const;
+
+    /*! The nodata value of the tile band as it appears in data that is read from the band as dataType */
+    static std::optional<double> tile_nodata(const RasterDataSet& tile, int bandNr, const std::type_info& dataType);
+
+    std::vector<MosaicTile> _tiles;
+    GeoMetadata _metadata;
+
+    std::vector<IndexNode> _nodes; // the root node is the last node
+    std::vector<uint32_t> _entries;
+};
+
+template <typename T>
+GeoMetadata RasterMosaic::read(const GeoMetadata& extent, int bandNr, std::span<T> dstData, const MosaicReadOptions& options) const
+{
+    if (truncate<int32_t>(dstData.size()) != extent.rows * extent.cols) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    auto dstMeta   = extent;
+    dstMeta.nodata = _metadata.nodata.has_value() ? _metadata.nodata : extent.nodata;
+
+    bool covered = false;
+    auto cutOuts = intersecting_cutouts(extent, covered);
+    if (cutOuts.empty()) {
+        if (!dstMeta.nodata.has_value()) {
+            dstMeta.nodata = static_cast<double>(std::numeric_limits<T>::max());
+        }
+
+        std::fill(dstData.begin(), dstData.end(), static_cast<T>(*dstMeta.nodata));
+        return dstMeta;
+    }
+
+    auto& cache = DataSetCache::instance();
+
+    // the nodata cells of the tiles are skipped, so the cells without data have to be filled with the mosaic nodata
+    const auto tilesWithNodata = std::any_of(cutOuts.begin(), cutOuts.end(), [&](const TileCutOut& tileCutOut) {
+        return cache.open_raster(_tiles[tileCutOut.tileIndex].path)->nodata_value(bandNr).has_value();
+    });
+
+    auto firstTile  = cache.open_raster(_tiles[cutOuts.front().tileIndex].path);
+    auto threads    = options.threadCount == 0 ? default_thread_count() : options.threadCount;
+    auto minStrip   = std::max(1, firstTile->rasterband(bandNr).block_size().height);
+    auto windowRead = [&](auto* data, int32_t row, int32_t rows) {
+        using DataType = std::remove_pointer_t<decltype(data)>;
+
+        // every strip reads the tiles in list order so the result does not depend on the scheduling
+        const auto stripRows  = std::max(minStrip, (rows + int32_t(threads) * 4 - 1) / (int32_t(threads) * 4));
+        const auto stripCount = (rows + stripRows - 1) / stripRows;
+        parallel_for(
+            stripCount, threads, []() { return std::vector<DataType>(); },
+            [&](std::vector<DataType>& tileData, int64_t strip) {
+                const auto stripRow = int32_t(strip) * stripRows;
+                const auto count    = std::min(stripRows, rows - stripRow);
+                auto* stripData     = data + size_t(stripRow) * dstMeta.cols;
+                for (auto& tileCutOut : cutOuts) {
+                    auto stripCutOut = io::detail::cutout_rows(tileCutOut.cutOut, row + stripRow, count);
+                    if (stripCutOut.rows <= 0 || stripCutOut.cols <= 0) {
+                        continue;
+                    }
+
+                    auto tile       = cache.open_raster(_tiles[tileCutOut.tileIndex].path);
+                    auto tileNodata = tile_nodata(*tile, bandNr, typeid(DataType));
+                    if (!tileNodata.has_value()) {
+                        io::detail::read_raster_data(bandNr, stripCutOut, *tile, stripData, dstMeta.cols);
+                        continue;
+                    }
+
+                    // read the tile separately and only copy the cells with data, the nodata is compared in the type of the data
+                    auto tileCut         = stripCutOut;
+                    tileCut.dstColOffset = 0;
+                    tileCut.dstRowOffset = 0;
+                    tileData.resize(size_t(tileCut.rows) * tileCut.cols);
+                    io::detail::read_raster_data(bandNr, tileCut, *tile, tileData.data(), tileCut.cols);
+
+                    const inf::detail::NodataMatcher<DataType> isNodata(tileNodata);
+                    for (int32_t r = 0; r < tileCut.rows; ++r) {
+                        const auto* srcRow = tileData.data() + size_t(r) * tileCut.cols;
+                        auto* dstRow       = stripData + size_t(std::max(0, stripCutOut.dstRowOffset) + r) * dstMeta.cols + std::max(0, stripCutOut.dstColOffset);
+                        for (int32_t c = 0; c < tileCut.cols; ++c) {
+                            if (!isNodata(srcRow[c])) {
+                                dstRow[c] = srcRow[c];
+                            }
+                        }
+                    }
+                }
+            });
+    };
+
+    return io::detail::read_window(*firstTile, bandNr, !covered || tilesWithNodata, dstMeta, dstData, windowRead);
+}
+
+}
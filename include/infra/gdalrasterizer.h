@@ -0,0 +1,28 @@
+#pragma once
+
+#include "infra/gdalgeometry.h"
+#include "infra/geometadata.h"
+#include "infra/span.h"
+
+namespace inf::gdal {
+
+/*! Lightweight polygon rasterization into a raster window, no gdal datasets or option lists are created
+ * so these functions are cheap to call for many small windows (e.g. zonal statistics).
+ * The data spans contain the cells of the window described by the metadata.
+ */
+
+/*! Sets the cells of which the centre lies inside the polygon to the burn value (the default behaviour of rasterize)
+ * Centres that lie exactly on an edge are resolved as in rasterize. The other cells are not modified.
+ */
+template <typename T>
+void burn_polygon(PolygonCRef polygon, const GeoMetadata& meta, T burnValue, std::span<T> data);
+template <typename T>
+void burn_polygon(MultiPolygonCRef polygon, const GeoMetadata& meta, T burnValue, std::span<T> data);
+
+/*! Calculates the exact fraction (0 - 1) of the area of every cell that is covered by the polygon
+ * The polygon has to be valid (no self intersections, holes inside the exterior ring) for the fractions to be exact.
+ */
+void polygon_coverage(PolygonCRef polygon, const GeoMetadata& meta, std::span<float> coverage);
+void polygon_coverage(MultiPolygonCRef polygon, const GeoMetadata& meta, std::span<float> coverage);
+
+}
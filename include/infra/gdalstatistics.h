@@ -0,0 +1,25 @@
+#pragma once
+
+#include "infra/filesystem.h"
+#include "infra/geometadata.h"
+#include "infra/rasterstatistics.h"
+#include "infra/span.h"
+
+#include <cstdint>
+
+namespace inf::gdal {
+
+/*! Computes the statistics of the raster band in a single pass, without reading the full band in memory
+ * The band is streamed in strips that are aligned to the blocks of the band and processed on multiple threads,
+ * every thread opens its own handle of the file.
+ * The nodata value of the band and NaN values are excluded, min, max, mean and stddev match RasterDataSet::statistics
+ */
+RasterStatistics compute_statistics(const fs::path& filePath, int bandNr, const StatisticsOptions& options = {});
+
+/*! Computes the statistics of the cells of the extent, cells of the extent outside of the raster are ignored
+ * The extent must have the cell size of the raster.
+ * mask: optional, has the size of the extent, cells with a zero mask value are ignored
+ */
+RasterStatistics compute_statistics(const fs::path& filePath, int bandNr, const GeoMetadata& extent, std::span<const uint8_t> mask, const StatisticsOptions& options = {});
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "infra/cast.h"
+#include "infra/exception.h"
+#include "infra/gdalresample.h"
+#include "infra/geometadata.h"
+#include "infra/parallelfor.h"
+#include "infra/rasterstatistics.h"
+#include "infra/span.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace inf::gdal {
+
+/*! A precomputed mapping of the cells of a destination grid to the cells of a source grid
+ * Use it to warp many rasters that share the same source grid to the same destination grid (e.g. the timesteps of model output)
+ * The coordinate transformation is only performed when the plan is created, applying the plan gathers the source values.
+ * Supported algorithms: nearest neighbour (a plain gather), bilinear and average (weighted sums)
+ * Source nodata values do not contribute to the result, the weights of the remaining cells are normalized (as in gdal warp)
+ */
+class WarpPlan
+{
+public:
+    WarpPlan(const GeoMetadata& srcMeta, const GeoMetadata& dstMeta, ResampleAlgorithm algo = ResampleAlgorithm::NearestNeighbour);
+
+    const GeoMetadata& source_metadata() const noexcept;
+    const GeoMetadata& destination_metadata() const noexcept;
+    ResampleAlgorithm algorithm() const noexcept;
+
+    /*! Warps the input data (described by the source metadata) to the output data, the rows are processed using multiple threads (0: default_thread_count)
+     * Returns the destination metadata, when the destination has no nodata value it is set as in warp_raster
+     */
+    template <typename TInput, typename TOutput>
+    GeoMetadata apply(std::span<const TInput> inputData, std::span<TOutput> outputData, uint32_t threadCount = 0) const;
+
+private:
+    static constexpr uint32_t s_noSource = std::numeric_limits<uint32_t>::max();
+
+    GeoMetadata _srcMeta;
+    GeoMetadata _dstMeta;
+    ResampleAlgorithm _algo;
+
+    // Compressed sparse row layout: the source cells of destination cell i are _indexes[_offsets[i], _offsets[i + 1]) with the matching _weights
+    // For nearest neighbour _offsets and _weights are empty and _indexes contains one source cell per destination cell (s_noSource when not covered)
+    std::vector<uint64_t> _offsets;
+    std::vector<uint32_t> _indexes;
+    std::vector<float> _weights;
+};
+
+template <typename TInput, typename TOutput>
+GeoMetadata WarpPlan::apply(std::span<const TInput> inputData, std::span<TOutput> outputData, uint32_t threadCount) const
+{
+    if (truncate<int32_t>(inputData.size()) != _srcMeta.rows * _srcMeta.cols) {
+        throw InvalidArgument("Invalid input data provided: incorrect size");
+    }
+
+    if (truncate<int32_t>(outputData.size()) != _dstMeta.rows * _dstMeta.cols) {
+        throw InvalidArgument("Invalid output data provided: incorrect size");
+    }
+
+    auto dstMeta = _dstMeta;
+    if (!dstMeta.nodata.has_value()) {
+        if constexpr (std::numeric_limits<TOutput>::has_quiet_NaN) {
+            dstMeta.nodata = std::numeric_limits<TOutput>::quiet_NaN();
+        } else {
+            dstMeta.nodata = std::numeric_limits<TOutput>::max();
+        }
+    }
+
+    // the source nodata is compared in the type of the input, NaN input values are nodata as well
+    const inf::detail::NodataMatcher<TInput> isNodata(_srcMeta.nodata);
+    const auto dstNodata = static_cast<TOutput>(*dstMeta.nodata);
+    const auto cols      = size_t(dstMeta.cols);
+
+    // process the destination in strips of roughly 64k cells to balance the load between the threads
+    const auto stripRows  = std::max<int64_t>(1, (1 << 16) / std::max<int64_t>(1, dstMeta.cols));
+    const auto stripCount = (dstMeta.rows + stripRows - 1) / stripRows;
+
+    parallel_for(stripCount, threadCount, [&](int64_t strip) {
+        const auto begin = size_t(strip * stripRows) * cols;
+        const auto end   = std::min(outputData.size(), begin + size_t(stripRows) * cols);
+
+        if (_offsets.empty()) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto index = _indexes[i];
+                if (index == s_noSource || isNodata(inputData[index])) {
+                    outputData[i] = dstNodata;
+                } else {
+                    outputData[i] = static_cast<TOutput>(inputData[index]);
+                }
+            }
+
+            return;
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            double sum       = 0.0;
+            double weightSum = 0.0;
+            for (auto entry = _offsets[i]; entry < _offsets[i + 1]; ++entry) {
+                const auto value = inputData[_indexes[entry]];
+                if (!isNodata(value)) {
+                    sum += double(value) * _weights[entry];
+                    weightSum += _weights[entry];
+                }
+            }
+
+            if (weightSum <= 0.0) {
+                outputData[i] = dstNodata;
+            } else if constexpr (std::is_integral_v<TOutput>) {
+                outputData[i] = static_cast<TOutput>(std::round(sum / weightSum));
+            } else {
+                outputData[i] = static_cast<TOutput>(sum / weightSum);
+            }
+        }
+    });
+
+    return dstMeta;
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "infra/filesystem.h"
+#include "infra/geometadata.h"
+#include "infra/progressinfo.h"
+#include "infra/span.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace inf::gdal {
+
+class Layer;
+
+struct ZonalStatisticsOptions
+{
+    bool coverageWeighting = false; //! weigh the cells with the fraction of the cell that is covered by the polygon, otherwise the cells of which the centre lies inside the polygon are used
+    bool majority          = false; //! compute the most frequent value in every zone, only useful for rasters with classes
+    uint32_t threadCount   = 0;     //! number of threads, 0 uses all available cores
+};
+
+struct ZonalStatistics
+{
+    int64_t fid = -1; //! the feature id of the zone
+
+    double count = 0.0; //! the (weighted) number of cells with data in the zone
+    double sum   = 0.0; //! the (weighted) sum of the cell values
+    double mean  = std::numeric_limits<double>::quiet_NaN();
+    double min   = std::numeric_limits<double>::quiet_NaN();
+    double max   = std::numeric_limits<double>::quiet_NaN();
+
+    double majority = std::numeric_limits<double>::quiet_NaN(); //! the value with the highest (weighted) cell count, the smallest value on a tie
+};
+
+/*! Computes the statistics of the raster cells inside every (multi)polygon feature of the layer
+ * The layer has to be in the projection of the raster (see Layer::set_active_projection).
+ * The features are distributed over the threads, only the cells in the envelope of a feature are read.
+ * Nodata and NaN cells are ignored, features without polygon geometry or without data cells have a count of 0.
+ * The result contains an entry for every feature in the order of the layer.
+ * Progress is reported per processed feature, CancelRequested is thrown when the callback aborts.
+ */
+std::vector<ZonalStatistics> zonal_statistics(const fs::path& rasterPath, int bandNr, Layer& layer, const ZonalStatisticsOptions& options = {}, const ProgressInfo::Callback& progressCb = nullptr);
+
+template <typename T>
+std::vector<ZonalStatistics> zonal_statistics(std::span<const T> data, const GeoMetadata& meta, Layer& layer, const ZonalStatisticsOptions& options = {}, const ProgressInfo::Callback& progressCb = nullptr);
+
+/*! Stores the statistics as fields of the features of the layer (matched on feature id)
+ * The fields <prefix>count, <prefix>sum, <prefix>mean, <prefix>min, <prefix>max (and <prefix>majority when enabled in the options)
+ * are created when they are not present, values of zones without data are set to null.
+ */
+void write_zonal_statistics(Layer& layer, std::span<const ZonalStatistics> statistics, const ZonalStatisticsOptions& options = {}, const std::string& fieldPrefix = {});
+
+}
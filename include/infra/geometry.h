@@ -22,6 +22,19 @@ std::string to_geojson(const GeoMetadata& meta);
 
 void calculate_geometry_envelopes(const geos::geom::Geometry& geom);
 
+struct PolygonizeTileOptions
+{
+    int32_t tileSize     = 2048; //! number of rows and columns of the tiles that are polygonized independently
+    uint32_t threadCount = 0;    //! number of threads that polygonize tiles, 0 uses all available cores
+};
+
+/*! Polygonizes the first band of the raster in tiles that are processed in parallel, the resulting polygons match gdal::polygonize
+ * Every thread opens its own copy of the raster. Polygons that do not touch a seam between tiles are written to the layer
+ * as soon as their tile is finished, the polygons that touch a seam are merged by value using GEOS unions when all the tiles are processed.
+ * The value of the polygons is stored in an integer "Value" field, which is created when the layer does not have it yet.
+ */
+void polygonize_tiled(const fs::path& rasterPath, gdal::Layer& layer, const PolygonizeTileOptions& options = {});
+
 class CoordinateWarpFilter : public geos::geom::CoordinateSequenceFilter
 {
 public:
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "infra/threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace inf {
+
+/*! The number of threads to use when no explicit thread count is requested */
+inline uint32_t default_thread_count() noexcept
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace detail {
+
+/*! The process wide thread pool that executes the parallel_for work next to the calling thread
+ * It is started on first use with default_thread_count threads
+ */
+ThreadPool& parallel_for_thread_pool();
+
+}
+
+/*! Invokes the callback for every index in the range [0, count) using up to threadCount threads (0: default_thread_count)
+ * The calling thread participates in the work, the other threads come from a shared thread pool so no threads
+ * are created per call, the call returns when all the indexes are processed.
+ * Every thread creates its own state using the state factory before processing indexes, use it
+ * for resources that cannot be shared between threads (e.g. dataset handles)
+ * Callback signature: void(State& state, int64_t index)
+ * The first exception thrown by a callback is rethrown on the calling thread, the remaining indexes are skipped.
+ * Calls can be nested: the calling thread never waits for pool jobs that did not start yet.
+ */
+template <typename StateFactory, typename Callback>
+void parallel_for(int64_t count, uint32_t threadCount, StateFactory&& createState, Callback&& cb)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    if (threadCount == 0) {
+        threadCount = default_thread_count();
+    }
+
+    threadCount = static_cast<uint32_t>(std::min<int64_t>(threadCount, count));
+
+    // Shared with the pool jobs, a job that starts after the call returned only touches this block
+    struct Control
+    {
+        std::mutex mutex;
+        std::condition_variable finished;
+        uint32_t activeJobs = 0;
+        bool closed         = false;
+    };
+
+    std::atomic<int64_t> nextIndex = 0;
+    std::atomic<bool> abort        = false;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        if (nextIndex >= count || abort) {
+            // nothing left to do, avoid creating the state
+            return;
+        }
+
+        try {
+            auto state = createState();
+            for (auto index = nextIndex++; index < count && !abort; index = nextIndex++) {
+                cb(state, index);
+            }
+        } catch (...) {
+            std::scoped_lock lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+
+            abort = true;
+        }
+    };
+
+    auto control = std::make_shared<Control>();
+    if (threadCount > 1) {
+        auto& pool = detail::parallel_for_thread_pool();
+        for (uint32_t i = 1; i < threadCount; ++i) {
+            pool.add_job([control, &worker]() {
+                {
+                    std::scoped_lock lock(control->mutex);
+                    if (control->closed) {
+                        return;
+                    }
+
+                    ++control->activeJobs;
+                }
+
+                worker();
+
+                std::scoped_lock lock(control->mutex);
+                if (--control->activeJobs == 0) {
+                    control->finished.notify_all();
+                }
+            });
+        }
+    }
+
+    worker();
+
+    {
+        // wait for the jobs that are running, the jobs that did not start yet will not touch the work anymore
+        std::unique_lock lock(control->mutex);
+        control->finished.wait(lock, [&]() { return control->activeJobs == 0; });
+        control->closed = true;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/*! Invokes the callback for every index in the range [0, count) using up to threadCount threads (0: default_thread_count)
+ * Callback signature: void(int64_t index)
+ */
+template <typename Callback>
+void parallel_for(int64_t count, uint32_t threadCount, Callback&& cb)
+{
+    parallel_for(
+        count, threadCount, []() { return 0; }, [&cb](int /*state*/, int64_t index) { cb(index); });
+}
+
+}
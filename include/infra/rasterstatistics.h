@@ -0,0 +1,268 @@
+#pragma once
+
+#include "infra/cast.h"
+#include "infra/exception.h"
+#include "infra/geometadata.h"
+#include "infra/parallelfor.h"
+#include "infra/span.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace inf {
+
+namespace detail {
+
+/*! Detects nodata cells by comparing in the type of the data (as gdal does), the nodata value is converted once
+ * A nodata value that is not representable in an integral data type or out of range matches no cells.
+ * NaN values of floating point data always match.
+ */
+template <typename T>
+class NodataMatcher
+{
+public:
+    explicit NodataMatcher(std::optional<double> nodata) noexcept
+    {
+        if (nodata.has_value() && fits_in_type<T>(*nodata)) {
+            const auto value = static_cast<T>(*nodata);
+            if (std::is_floating_point_v<T> || static_cast<double>(value) == *nodata) {
+                _nodata = value;
+            }
+        }
+    }
+
+    bool operator()(T value) const noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            if (std::isnan(value)) {
+                return true;
+            }
+        }
+
+        return _nodata.has_value() && value == *_nodata;
+    }
+
+private:
+    std::optional<T> _nodata;
+};
+
+}
+
+struct StatisticsOptions
+{
+    int32_t histogramBins = 0;        //! number of histogram bins, 0 disables the histogram
+    double histogramMin   = 0.0;      //! lower bound of the first histogram bin
+    double histogramMax   = 0.0;      //! upper bound of the last histogram bin (inclusive)
+    std::vector<double> percentiles;  //! percentiles to estimate in the range [0, 100]
+    double percentileAccuracy = 0.01; //! relative accuracy of the percentile estimates
+    uint32_t threadCount      = 0;    //! number of threads, 0 uses all available cores
+};
+
+struct RasterStatistics
+{
+    double min    = std::numeric_limits<double>::quiet_NaN();
+    double max    = std::numeric_limits<double>::quiet_NaN();
+    double mean   = std::numeric_limits<double>::quiet_NaN();
+    double stddev = std::numeric_limits<double>::quiet_NaN(); //! population standard deviation
+    double sum    = 0.0;
+
+    uint64_t count       = 0; //! number of cells with data
+    uint64_t nodataCount = 0; //! number of nodata (or NaN) cells, masked cells are not counted
+
+    std::vector<uint64_t> histogram; //! cell counts per bin, values outside of the histogram range are not counted
+    std::vector<double> percentiles; //! the estimated values of the requested percentiles (same order)
+};
+
+/*! Mergeable streaming quantile estimation with a relative accuracy guarantee
+ * Values are counted in logarithmically sized buckets, so the memory usage only depends on the range of the values.
+ * Values closer to zero than 1e-12 are treated as zero.
+ */
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(double relativeAccuracy = 0.01);
+
+    void add(double value);
+    void merge(const QuantileSketch& other);
+
+    uint64_t count() const noexcept;
+
+    /*! The value at quantile q [0, 1], NaN when the sketch is empty */
+    double quantile(double q) const;
+
+private:
+    struct Store
+    {
+        void add(int32_t index, uint64_t count);
+        void merge(const Store& other);
+
+        int32_t offset = 0;
+        std::vector<uint64_t> counts;
+    };
+
+    int32_t bucket_index(double absValue) const;
+    double bucket_value(int32_t index) const;
+
+    double _gamma;
+    double _logGamma;
+    Store _positive;
+    Store _negative;
+    uint64_t _zeroCount = 0;
+};
+
+/*! Accumulates the statistics of blocks of raster data
+ * The accumulators of different blocks can be merged, which allows to process the blocks in parallel.
+ * Mean and variance are computed per block in two passes and merged using the parallel algorithm of Chan et al.
+ */
+class StatisticsAccumulator
+{
+public:
+    explicit StatisticsAccumulator(const StatisticsOptions& options);
+
+    /*! Adds the cells of the block, nodata and NaN cells are counted as nodata (the nodata is compared in the type of the data)
+     * mask: optional, cells with a zero mask value are ignored, must have the size of the data when not empty
+     */
+    template <typename T>
+    void add(std::span<const T> data, std::optional<double> nodata, std::span<const uint8_t> mask = {})
+    {
+        if (!mask.empty() && mask.size() != data.size()) {
+            throw InvalidArgument("Mask size does not match the data size ({} <-> {})", mask.size(), data.size());
+        }
+
+        const detail::NodataMatcher<T> isNodata(nodata);
+        auto isData = [&](size_t i) {
+            return !isNodata(data[i]);
+        };
+
+        auto isIncluded = [&](size_t i) {
+            return mask.empty() || mask[i] != 0;
+        };
+
+        uint64_t count       = 0;
+        uint64_t nodataCount = 0;
+        double sum           = 0.0;
+        double min           = std::numeric_limits<double>::max();
+        double max           = std::numeric_limits<double>::lowest();
+
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (!isIncluded(i)) {
+                continue;
+            }
+
+            if (!isData(i)) {
+                ++nodataCount;
+                continue;
+            }
+
+            const auto value = static_cast<double>(data[i]);
+            ++count;
+            sum += value;
+            min = std::min(min, value);
+            max = std::max(max, value);
+            add_to_distribution(value);
+        }
+
+        _nodataCount += nodataCount;
+        if (count == 0) {
+            return;
+        }
+
+        const auto mean = sum / double(count);
+        double m2       = 0.0;
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (isIncluded(i) && isData(i)) {
+                const auto delta = static_cast<double>(data[i]) - mean;
+                m2 += delta * delta;
+            }
+        }
+
+        merge_moments(count, sum, mean, m2, min, max);
+    }
+
+    void merge(const StatisticsAccumulator& other);
+
+    RasterStatistics result() const;
+
+private:
+    void add_to_distribution(double value)
+    {
+        if (!_histogram.empty() && value >= _histogramMin && value <= _histogramMax) {
+            const auto bin = std::min(static_cast<size_t>((value - _histogramMin) * _binScale), _histogram.size() - 1);
+            ++_histogram[bin];
+        }
+
+        if (_sketch) {
+            _sketch->add(value);
+        }
+    }
+
+    void merge_moments(uint64_t count, double sum, double mean, double m2, double min, double max);
+
+    uint64_t _count       = 0;
+    uint64_t _nodataCount = 0;
+    double _sum           = 0.0;
+    double _mean          = 0.0;
+    double _m2            = 0.0;
+    double _min           = std::numeric_limits<double>::max();
+    double _max           = std::numeric_limits<double>::lowest();
+
+    double _histogramMin = 0.0;
+    double _histogramMax = 0.0;
+    double _binScale     = 0.0;
+    std::vector<uint64_t> _histogram;
+
+    std::vector<double> _percentiles;
+    std::optional<QuantileSketch> _sketch;
+};
+
+namespace detail {
+// Number of cells that are processed as one block by the statistics functions
+inline constexpr size_t s_statisticsBlockSize = 256 * 1024;
+}
+
+/*! Computes the statistics of the raster data in a single pass over the data using multiple threads
+ * The nodata value of the metadata and NaN values are excluded from the statistics.
+ * mask: optional, cells with a zero mask value are ignored, must have the size of the data when not empty
+ * The results do not depend on the number of threads.
+ */
+template <typename T>
+RasterStatistics compute_statistics(const GeoMetadata& meta, std::span<const T> data, std::span<const uint8_t> mask, const StatisticsOptions& options = {})
+{
+    if (data.size() != size_t(meta.rows) * size_t(meta.cols)) {
+        throw InvalidArgument("Invalid data buffer provided: incorrect size");
+    }
+
+    if (!mask.empty() && mask.size() != data.size()) {
+        throw InvalidArgument("Mask size does not match the data size ({} <-> {})", mask.size(), data.size());
+    }
+
+    const auto blockCount = (data.size() + detail::s_statisticsBlockSize - 1) / detail::s_statisticsBlockSize;
+
+    // every block gets its own accumulator, merging them in order makes the result independent of the scheduling
+    std::vector<StatisticsAccumulator> blockStats(blockCount, StatisticsAccumulator(options));
+    parallel_for(int64_t(blockCount), options.threadCount, [&](int64_t index) {
+        const auto offset = size_t(index) * detail::s_statisticsBlockSize;
+        const auto size   = std::min(detail::s_statisticsBlockSize, data.size() - offset);
+        blockStats[index].add(data.subspan(offset, size), meta.nodata, mask.empty() ? mask : mask.subspan(offset, size));
+    });
+
+    StatisticsAccumulator result(options);
+    for (auto& stats : blockStats) {
+        result.merge(stats);
+    }
+
+    return result.result();
+}
+
+template <typename T>
+RasterStatistics compute_statistics(const GeoMetadata& meta, std::span<const T> data, const StatisticsOptions& options = {})
+{
+    return compute_statistics<T>(meta, data, std::span<const uint8_t>(), options);
+}
+
+}
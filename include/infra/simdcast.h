@@ -0,0 +1,31 @@
+#pragma once
+
+#include "infra/span.h"
+
+#include <cstdint>
+
+namespace inf::simd {
+
+/* Vectorized type conversions for the common raster type pairs
+ * The implementation is selected at runtime: AVX2 when supported by the cpu, SSE2 otherwise (scalar on non x86 platforms)
+ * The results are identical to a static_cast of every element, the source and destination spans must have the same size.
+ */
+
+void cast(std::span<const float> src, std::span<double> dst) noexcept;
+void cast(std::span<const double> src, std::span<float> dst) noexcept;
+void cast(std::span<const int32_t> src, std::span<float> dst) noexcept;
+void cast(std::span<const float> src, std::span<int32_t> dst) noexcept;
+void cast(std::span<const uint8_t> src, std::span<float> dst) noexcept;
+void cast(std::span<const float> src, std::span<uint8_t> dst) noexcept;
+
+/*! Converts the values to float, values equal to nodata are converted to NaN */
+void cast_nodata_to_nan(std::span<const int32_t> src, int32_t nodata, std::span<float> dst) noexcept;
+void cast_nodata_to_nan(std::span<const uint8_t> src, uint8_t nodata, std::span<float> dst) noexcept;
+
+/*! Converts the float values, NaN values and values equal to srcNodata are converted to dstNodata
+ * Pass NaN as srcNodata to only replace the NaN values
+ */
+void cast_nan_to_nodata(std::span<const float> src, float srcNodata, int32_t dstNodata, std::span<int32_t> dst) noexcept;
+void cast_nan_to_nodata(std::span<const float> src, float srcNodata, uint8_t dstNodata, std::span<uint8_t> dst) noexcept;
+
+}
@@ -0,0 +1,37 @@
+#include "infra/parallelfor.h"
+
+namespace inf::detail {
+
+namespace {
+
+class SharedThreadPool
+{
+public:
+    SharedThreadPool()
+    {
+        _pool.start(default_thread_count());
+    }
+
+    ~SharedThreadPool()
+    {
+        _pool.stop();
+    }
+
+    ThreadPool& pool() noexcept
+    {
+        return _pool;
+    }
+
+private:
+    ThreadPool _pool;
+};
+
+}
+
+ThreadPool& parallel_for_thread_pool()
+{
+    static SharedThreadPool pool;
+    return pool.pool();
+}
+
+}
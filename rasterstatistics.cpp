@@ -0,0 +1,226 @@
+#include "infra/rasterstatistics.h"
+
+#include <cassert>
+
+namespace inf {
+
+static constexpr double s_minIndexableValue = 1e-12;
+
+QuantileSketch::QuantileSketch(double relativeAccuracy)
+{
+    if (relativeAccuracy <= 0.0 || relativeAccuracy >= 1.0) {
+        throw InvalidArgument("Invalid quantile accuracy: {}", relativeAccuracy);
+    }
+
+    _gamma    = (1.0 + relativeAccuracy) / (1.0 - relativeAccuracy);
+    _logGamma = std::log(_gamma);
+}
+
+void QuantileSketch::Store::add(int32_t index, uint64_t count)
+{
+    if (counts.empty()) {
+        offset = index;
+        counts.push_back(count);
+        return;
+    }
+
+    if (index < offset) {
+        counts.insert(counts.begin(), size_t(offset - index), 0);
+        offset = index;
+    } else if (index >= offset + int32_t(counts.size())) {
+        counts.resize(size_t(index - offset) + 1, 0);
+    }
+
+    counts[size_t(index - offset)] += count;
+}
+
+void QuantileSketch::Store::merge(const Store& other)
+{
+    for (size_t i = 0; i < other.counts.size(); ++i) {
+        if (other.counts[i] != 0) {
+            add(other.offset + int32_t(i), other.counts[i]);
+        }
+    }
+}
+
+int32_t QuantileSketch::bucket_index(double absValue) const
+{
+    // infinite values are counted in the bucket of the largest finite value
+    return static_cast<int32_t>(std::ceil(std::log(std::min(absValue, std::numeric_limits<double>::max())) / _logGamma));
+}
+
+double QuantileSketch::bucket_value(int32_t index) const
+{
+    // the value in the middle of the bucket (gamma^(i-1), gamma^i] in terms of relative error
+    return 2.0 * std::pow(_gamma, index) / (_gamma + 1.0);
+}
+
+void QuantileSketch::add(double value)
+{
+    if (value > s_minIndexableValue) {
+        _positive.add(bucket_index(value), 1);
+    } else if (value < -s_minIndexableValue) {
+        _negative.add(bucket_index(-value), 1);
+    } else {
+        ++_zeroCount;
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    assert(_gamma == other._gamma);
+    _positive.merge(other._positive);
+    _negative.merge(other._negative);
+    _zeroCount += other._zeroCount;
+}
+
+uint64_t QuantileSketch::count() const noexcept
+{
+    uint64_t result = _zeroCount;
+    for (auto count : _positive.counts) {
+        result += count;
+    }
+
+    for (auto count : _negative.counts) {
+        result += count;
+    }
+
+    return result;
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    const auto total = count();
+    if (total == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const auto rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * double(total - 1));
+
+    // negative values in ascending order: from the largest absolute value to the smallest
+    uint64_t seen = 0;
+    for (auto i = _negative.counts.size(); i-- > 0;) {
+        seen += _negative.counts[i];
+        if (seen > rank) {
+            return -bucket_value(_negative.offset + int32_t(i));
+        }
+    }
+
+    seen += _zeroCount;
+    if (seen > rank) {
+        return 0.0;
+    }
+
+    for (size_t i = 0; i < _positive.counts.size(); ++i) {
+        seen += _positive.counts[i];
+        if (seen > rank) {
+            return bucket_value(_positive.offset + int32_t(i));
+        }
+    }
+
+    return bucket_value(_positive.offset + int32_t(_positive.counts.size()) - 1);
+}
+
+StatisticsAccumulator::StatisticsAccumulator(const StatisticsOptions& options)
+: _histogramMin(options.histogramMin)
+, _histogramMax(options.histogramMax)
+, _percentiles(options.percentiles)
+{
+    if (options.histogramBins < 0) {
+        throw InvalidArgument("Invalid histogram bin count: {}", options.histogramBins);
+    }
+
+    if (options.histogramBins > 0) {
+        if (!(options.histogramMax > options.histogramMin)) {
+            throw InvalidArgument("Invalid histogram range: [{}, {}]", options.histogramMin, options.histogramMax);
+        }
+
+        _histogram.resize(size_t(options.histogramBins), 0);
+        _binScale = options.histogramBins / (options.histogramMax - options.histogramMin);
+    }
+
+    for (auto percentile : _percentiles) {
+        if (!(percentile >= 0.0 && percentile <= 100.0)) {
+            throw InvalidArgument("Invalid percentile: {}", percentile);
+        }
+    }
+
+    if (!_percentiles.empty()) {
+        _sketch.emplace(options.percentileAccuracy);
+    }
+}
+
+void StatisticsAccumulator::merge_moments(uint64_t count, double sum, double mean, double m2, double min, double max)
+{
+    if (count == 0) {
+        return;
+    }
+
+    if (_count == 0) {
+        _count = count;
+        _sum   = sum;
+        _mean  = mean;
+        _m2    = m2;
+        _min   = min;
+        _max   = max;
+        return;
+    }
+
+    const auto totalCount = _count + count;
+    const auto delta      = mean - _mean;
+
+    _mean += delta * double(count) / double(totalCount);
+    _m2 += m2 + delta * delta * (double(_count) * double(count) / double(totalCount));
+    _sum += sum;
+    _count = totalCount;
+    _min   = std::min(_min, min);
+    _max   = std::max(_max, max);
+}
+
+void StatisticsAccumulator::merge(const StatisticsAccumulator& other)
+{
+    if (_histogram.size() != other._histogram.size() || _percentiles.size() != other._percentiles.size()) {
+        throw InvalidArgument("Statistics with different options can not be merged");
+    }
+
+    merge_moments(other._count, other._sum, other._mean, other._m2, other._min, other._max);
+    _nodataCount += other._nodataCount;
+
+    for (size_t i = 0; i < _histogram.size(); ++i) {
+        _histogram[i] += other._histogram[i];
+    }
+
+    if (_sketch && other._sketch) {
+        _sketch->merge(*other._sketch);
+    }
+}
+
+RasterStatistics StatisticsAccumulator::result() const
+{
+    RasterStatistics result;
+    result.count       = _count;
+    result.nodataCount = _nodataCount;
+    result.histogram   = _histogram;
+
+    if (_count > 0) {
+        result.min    = _min;
+        result.max    = _max;
+        result.mean   = _mean;
+        result.stddev = std::sqrt(_m2 / double(_count));
+        result.sum    = _sum;
+    }
+
+    for (auto percentile : _percentiles) {
+        auto value = _sketch->quantile(percentile / 100.0);
+        if (_count > 0) {
+            // the bucket value can be slightly outside of the data range
+            value = std::clamp(value, _min, _max);
+        }
+
+        result.percentiles.push_back(value);
+    }
+
+    return result;
+}
+
+}
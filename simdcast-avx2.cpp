@@ -0,0 +1,151 @@
+#include "simdcast-avx2.h"
+
+#include <immintrin.h>
+#include <limits>
+
+// This file is compiled with avx2 code generation enabled, the kernels must only be called
+// after checking cpuinfo::supports_avx2, so keep them out of the headers
+
+namespace inf::simd::avx2 {
+
+static __m128i pack_low_bytes(__m256i values) noexcept
+{
+    // keep the low byte of each value (static_cast truncation), the values then fit in the signed 16 bit saturation range
+    values     = _mm256_and_si256(values, _mm256_set1_epi32(0xFF));
+    auto words = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+    return _mm_packus_epi16(words, words);
+}
+
+static __m256 load_bytes_as_float(const uint8_t* src) noexcept
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+}
+
+size_t cast(const float* src, double* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+        _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+    }
+
+    return i;
+}
+
+size_t cast(const double* src, float* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_ps(dst + i, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i)));
+        _mm_storeu_ps(dst + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4)));
+    }
+
+    return i;
+}
+
+size_t cast(const int32_t* src, float* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+    }
+
+    return i;
+}
+
+size_t cast(const float* src, int32_t* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvttps_epi32(_mm256_loadu_ps(src + i)));
+    }
+
+    return i;
+}
+
+size_t cast(const uint8_t* src, float* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(dst + i, load_bytes_as_float(src + i));
+    }
+
+    return i;
+}
+
+size_t cast(const float* src, uint8_t* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto values = _mm256_cvttps_epi32(_mm256_loadu_ps(src + i));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), pack_low_bytes(values));
+    }
+
+    return i;
+}
+
+size_t cast_nodata_to_nan(const int32_t* src, int32_t nodata, float* dst, size_t count) noexcept
+{
+    const auto nodataValue = _mm256_set1_epi32(nodata);
+    const auto nan         = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        auto mask   = _mm256_castsi256_ps(_mm256_cmpeq_epi32(values, nodataValue));
+        _mm256_storeu_ps(dst + i, _mm256_blendv_ps(_mm256_cvtepi32_ps(values), nan, mask));
+    }
+
+    return i;
+}
+
+size_t cast_nodata_to_nan(const uint8_t* src, uint8_t nodata, float* dst, size_t count) noexcept
+{
+    const auto nodataValue = _mm256_set1_ps(float(nodata));
+    const auto nan         = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto values = load_bytes_as_float(src + i);
+        auto mask   = _mm256_cmp_ps(values, nodataValue, _CMP_EQ_OQ);
+        _mm256_storeu_ps(dst + i, _mm256_blendv_ps(values, nan, mask));
+    }
+
+    return i;
+}
+
+static __m256i cast_nan_to_nodata(__m256 values, __m256 srcNodata, __m256i dstNodata) noexcept
+{
+    auto mask = _mm256_or_ps(_mm256_cmp_ps(values, values, _CMP_UNORD_Q), _mm256_cmp_ps(values, srcNodata, _CMP_EQ_OQ));
+    return _mm256_blendv_epi8(_mm256_cvttps_epi32(values), dstNodata, _mm256_castps_si256(mask));
+}
+
+size_t cast_nan_to_nodata(const float* src, float srcNodata, int32_t dstNodata, int32_t* dst, size_t count) noexcept
+{
+    const auto srcNodataValue = _mm256_set1_ps(srcNodata);
+    const auto dstNodataValue = _mm256_set1_epi32(dstNodata);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto values = cast_nan_to_nodata(_mm256_loadu_ps(src + i), srcNodataValue, dstNodataValue);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), values);
+    }
+
+    return i;
+}
+
+size_t cast_nan_to_nodata(const float* src, float srcNodata, uint8_t dstNodata, uint8_t* dst, size_t count) noexcept
+{
+    const auto srcNodataValue = _mm256_set1_ps(srcNodata);
+    const auto dstNodataValue = _mm256_set1_epi32(dstNodata);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto values = cast_nan_to_nodata(_mm256_loadu_ps(src + i), srcNodataValue, dstNodataValue);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), pack_low_bytes(values));
+    }
+
+    return i;
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// AVX2 kernels, only available when building for x86_64 (INFRA_SIMD_AVX2)
+// Only call these when cpuinfo::supports_avx2() returns true
+// The kernels process the elements in multiples of 8, the number of processed elements is returned
+namespace inf::simd::avx2 {
+
+size_t cast(const float* src, double* dst, size_t count) noexcept;
+size_t cast(const double* src, float* dst, size_t count) noexcept;
+size_t cast(const int32_t* src, float* dst, size_t count) noexcept;
+size_t cast(const float* src, int32_t* dst, size_t count) noexcept;
+size_t cast(const uint8_t* src, float* dst, size_t count) noexcept;
+size_t cast(const float* src, uint8_t* dst, size_t count) noexcept;
+
+size_t cast_nodata_to_nan(const int32_t* src, int32_t nodata, float* dst, size_t count) noexcept;
+size_t cast_nodata_to_nan(const uint8_t* src, uint8_t nodata, float* dst, size_t count) noexcept;
+
+size_t cast_nan_to_nodata(const float* src, float srcNodata, int32_t dstNodata, int32_t* dst, size_t count) noexcept;
+size_t cast_nan_to_nodata(const float* src, float srcNodata, uint8_t dstNodata, uint8_t* dst, size_t count) noexcept;
+
+}
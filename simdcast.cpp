@@ -0,0 +1,306 @@
+#include "infra/simdcast.h"
+#include "infra/cpuinfo.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define INFRA_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define INFRA_SIMD_SSE2 0
+#endif
+
+#ifdef INFRA_SIMD_AVX2
+#include "simdcast-avx2.h"
+#endif
+
+namespace inf::simd {
+
+namespace {
+
+#ifdef INFRA_SIMD_AVX2
+bool use_avx2() noexcept
+{
+    static const bool avx2 = cpuinfo::supports_avx2();
+    return avx2;
+}
+#endif
+
+// Scalar implementations, used for the remaining elements of the vectorized loops
+
+template <typename TSource, typename TDest>
+void cast_scalar(const TSource* src, TDest* dst, size_t begin, size_t end) noexcept
+{
+    for (size_t i = begin; i < end; ++i) {
+        dst[i] = static_cast<TDest>(src[i]);
+    }
+}
+
+template <typename TSource>
+void cast_nodata_to_nan_scalar(const TSource* src, TSource nodata, float* dst, size_t begin, size_t end) noexcept
+{
+    for (size_t i = begin; i < end; ++i) {
+        dst[i] = src[i] == nodata ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(src[i]);
+    }
+}
+
+template <typename TDest>
+void cast_nan_to_nodata_scalar(const float* src, float srcNodata, TDest dstNodata, TDest* dst, size_t begin, size_t end) noexcept
+{
+    for (size_t i = begin; i < end; ++i) {
+        dst[i] = (std::isnan(src[i]) || src[i] == srcNodata) ? dstNodata : static_cast<TDest>(src[i]);
+    }
+}
+
+#if INFRA_SIMD_SSE2
+
+namespace sse2 {
+
+__m128i pack_low_bytes(__m128i values) noexcept
+{
+    // keep the low byte of each value (static_cast truncation), the values then fit in the signed 16 bit saturation range
+    values     = _mm_and_si128(values, _mm_set1_epi32(0xFF));
+    auto words = _mm_packs_epi32(values, values);
+    return _mm_packus_epi16(words, words);
+}
+
+__m128 load_bytes_as_float(const uint8_t* src) noexcept
+{
+    int32_t bytes;
+    std::memcpy(&bytes, src, sizeof(bytes));
+    auto zero   = _mm_setzero_si128();
+    auto values = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+    return _mm_cvtepi32_ps(values);
+}
+
+void store_bytes(uint8_t* dst, __m128i bytes) noexcept
+{
+    auto value = _mm_cvtsi128_si32(bytes);
+    std::memcpy(dst, &value, sizeof(value));
+}
+
+__m128 select(__m128 mask, __m128 ifTrue, __m128 ifFalse) noexcept
+{
+    return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+__m128i cast_nan_to_nodata(__m128 values, __m128 srcNodata, __m128i dstNodata) noexcept
+{
+    auto mask = _mm_castps_si128(_mm_or_ps(_mm_cmpunord_ps(values, values), _mm_cmpeq_ps(values, srcNodata)));
+    return _mm_or_si128(_mm_and_si128(mask, dstNodata), _mm_andnot_si128(mask, _mm_cvttps_epi32(values)));
+}
+
+size_t cast(const float* src, double* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto values = _mm_loadu_ps(src + i);
+        _mm_storeu_pd(dst + i, _mm_cvtps_pd(values));
+        _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+    }
+
+    return i;
+}
+
+size_t cast(const double* src, float* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto low  = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        auto high = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(low, high));
+    }
+
+    return i;
+}
+
+size_t cast(const int32_t* src, float* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+    }
+
+    return i;
+}
+
+size_t cast(const float* src, int32_t* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvttps_epi32(_mm_loadu_ps(src + i)));
+    }
+
+    return i;
+}
+
+size_t cast(const uint8_t* src, float* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, load_bytes_as_float(src + i));
+    }
+
+    return i;
+}
+
+size_t cast(const float* src, uint8_t* dst, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        store_bytes(dst + i, pack_low_bytes(_mm_cvttps_epi32(_mm_loadu_ps(src + i))));
+    }
+
+    return i;
+}
+
+size_t cast_nodata_to_nan(const int32_t* src, int32_t nodata, float* dst, size_t count) noexcept
+{
+    const auto nodataValue = _mm_set1_epi32(nodata);
+    const auto nan         = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        auto mask   = _mm_castsi128_ps(_mm_cmpeq_epi32(values, nodataValue));
+        _mm_storeu_ps(dst + i, select(mask, nan, _mm_cvtepi32_ps(values)));
+    }
+
+    return i;
+}
+
+size_t cast_nodata_to_nan(const uint8_t* src, uint8_t nodata, float* dst, size_t count) noexcept
+{
+    const auto nodataValue = _mm_set1_ps(float(nodata));
+    const auto nan         = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto values = load_bytes_as_float(src + i);
+        _mm_storeu_ps(dst + i, select(_mm_cmpeq_ps(values, nodataValue), nan, values));
+    }
+
+    return i;
+}
+
+size_t cast_nan_to_nodata(const float* src, float srcNodata, int32_t dstNodata, int32_t* dst, size_t count) noexcept
+{
+    const auto srcNodataValue = _mm_set1_ps(srcNodata);
+    const auto dstNodataValue = _mm_set1_epi32(dstNodata);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto values = cast_nan_to_nodata(_mm_loadu_ps(src + i), srcNodataValue, dstNodataValue);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), values);
+    }
+
+    return i;
+}
+
+size_t cast_nan_to_nodata(const float* src, float srcNodata, uint8_t dstNodata, uint8_t* dst, size_t count) noexcept
+{
+    const auto srcNodataValue = _mm_set1_ps(srcNodata);
+    const auto dstNodataValue = _mm_set1_epi32(dstNodata);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto values = cast_nan_to_nodata(_mm_loadu_ps(src + i), srcNodataValue, dstNodataValue);
+        store_bytes(dst + i, pack_low_bytes(values));
+    }
+
+    return i;
+}
+
+}
+
+#endif
+
+// Runs the widest available kernel, the remaining elements are processed by the scalar implementation
+#ifdef INFRA_SIMD_AVX2
+#define INFRA_SIMD_DISPATCH(func, ...) (use_avx2() ? avx2::func(__VA_ARGS__) : sse2::func(__VA_ARGS__))
+#elif INFRA_SIMD_SSE2
+#define INFRA_SIMD_DISPATCH(func, ...) sse2::func(__VA_ARGS__)
+#else
+#define INFRA_SIMD_DISPATCH(func, ...) size_t(0)
+#endif
+
+template <typename TSource, typename TDest>
+void cast_impl(std::span<const TSource> src, std::span<TDest> dst) noexcept
+{
+    assert(src.size() == dst.size());
+    auto processed = INFRA_SIMD_DISPATCH(cast, src.data(), dst.data(), src.size());
+    cast_scalar(src.data(), dst.data(), processed, src.size());
+}
+
+template <typename TSource>
+void cast_nodata_to_nan_impl(std::span<const TSource> src, TSource nodata, std::span<float> dst) noexcept
+{
+    assert(src.size() == dst.size());
+    auto processed = INFRA_SIMD_DISPATCH(cast_nodata_to_nan, src.data(), nodata, dst.data(), src.size());
+    cast_nodata_to_nan_scalar(src.data(), nodata, dst.data(), processed, src.size());
+}
+
+template <typename TDest>
+void cast_nan_to_nodata_impl(std::span<const float> src, float srcNodata, TDest dstNodata, std::span<TDest> dst) noexcept
+{
+    assert(src.size() == dst.size());
+    auto processed = INFRA_SIMD_DISPATCH(cast_nan_to_nodata, src.data(), srcNodata, dstNodata, dst.data(), src.size());
+    cast_nan_to_nodata_scalar(src.data(), srcNodata, dstNodata, dst.data(), processed, src.size());
+}
+
+}
+
+void cast(std::span<const float> src, std::span<double> dst) noexcept
+{
+    cast_impl(src, dst);
+}
+
+void cast(std::span<const double> src, std::span<float> dst) noexcept
+{
+    cast_impl(src, dst);
+}
+
+void cast(std::span<const int32_t> src, std::span<float> dst) noexcept
+{
+    cast_impl(src, dst);
+}
+
+void cast(std::span<const float> src, std::span<int32_t> dst) noexcept
+{
+    cast_impl(src, dst);
+}
+
+void cast(std::span<const uint8_t> src, std::span<float> dst) noexcept
+{
+    cast_impl(src, dst);
+}
+
+void cast(std::span<const float> src, std::span<uint8_t> dst) noexcept
+{
+    cast_impl(src, dst);
+}
+
+void cast_nodata_to_nan(std::span<const int32_t> src, int32_t nodata, std::span<float> dst) noexcept
+{
+    cast_nodata_to_nan_impl(src, nodata, dst);
+}
+
+void cast_nodata_to_nan(std::span<const uint8_t> src, uint8_t nodata, std::span<float> dst) noexcept
+{
+    cast_nodata_to_nan_impl(src, nodata, dst);
+}
+
+void cast_nan_to_nodata(std::span<const float> src, float srcNodata, int32_t dstNodata, std::span<int32_t> dst) noexcept
+{
+    cast_nan_to_nodata_impl(src, srcNodata, dstNodata, dst);
+}
+
+void cast_nan_to_nodata(std::span<const float> src, float srcNodata, uint8_t dstNodata, std::span<uint8_t> dst) noexcept
+{
+    cast_nan_to_nodata_impl(src, srcNodata, dstNodata, dst);
+}
+
+}
@@ -0,0 +1,67 @@
+#include "infra/gdaldatasetcache.h"
+#include "infra/gdalio.h"
+
+#include <doctest/doctest.h>
+
+namespace inf::test {
+
+using namespace doctest;
+
+TEST_CASE("Gdal.dataSetCache")
+{
+    gdal::DataSetCache cache(2);
+
+    SUBCASE("handles are reused")
+    {
+        {
+            auto ds = cache.open_raster(TEST_DATA_DIR "/raster.tif");
+            CHECK(ds->is_valid());
+            CHECK(cache.stats().leases == 1);
+        }
+
+        CHECK(cache.stats().idleHandles == 1);
+        CHECK(cache.read_metadata(TEST_DATA_DIR "/raster.tif") == gdal::io::read_metadata(TEST_DATA_DIR "/raster.tif"));
+        CHECK(cache.get_raster_type(TEST_DATA_DIR "/raster.tif") == gdal::io::get_raster_type(TEST_DATA_DIR "/raster.tif"));
+
+        auto stats = cache.stats();
+        CHECK(stats.misses == 1);
+        CHECK(stats.hits == 2);
+        CHECK(stats.leases == 0);
+    }
+
+    SUBCASE("leases are exclusive")
+    {
+        auto ds1 = cache.open_raster(TEST_DATA_DIR "/raster.tif");
+        auto ds2 = cache.open_raster(TEST_DATA_DIR "/raster.tif");
+        CHECK(ds1->is_valid());
+        CHECK(ds2->is_valid());
+        CHECK(cache.stats().misses == 2);
+    }
+
+    SUBCASE("driver options are part of the key")
+    {
+        cache.open_vector(TEST_DATA_DIR "/points.shp");
+        cache.open_vector(TEST_DATA_DIR "/points.shp", gdal::OpenMode::ReadOnly, {"ADJUST_TYPE=YES"});
+        CHECK(cache.stats().misses == 2);
+        CHECK(cache.stats().idleHandles == 2);
+    }
+
+    SUBCASE("least recently used handles are evicted")
+    {
+        cache.open_raster(TEST_DATA_DIR "/raster.tif");
+        cache.open_raster(TEST_DATA_DIR "/epsg31370.tif");
+        cache.open_raster(TEST_DATA_DIR "/epsg3857.tif");
+
+        auto stats = cache.stats();
+        CHECK(stats.idleHandles == 2);
+        CHECK(stats.evictions == 1);
+
+        cache.open_raster(TEST_DATA_DIR "/epsg3857.tif");
+        CHECK(cache.stats().hits == 1);
+
+        cache.clear();
+        CHECK(cache.stats().idleHandles == 0);
+    }
+}
+
+}
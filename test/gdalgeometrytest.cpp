@@ -1,7 +1,10 @@
+#include "infra/gdalalgo.h"
 #include "infra/gdalgeometry.h"
+#include "infra/gdalrasterizer.h"
 
 #include <doctest/doctest.h>
 #include <fstream>
+#include <numeric>
 #include <type_traits>
 
 #include "infra/log.h"
@@ -88,4 +91,135 @@ TEST_CASE("Geometry operations")
 
     CHECK_FALSE(polygon.contains(Point(0.5, 0.5)));
 }
+
+static Owner<LinearRingRef> create_rect_ring(Point<double> topLeft, Point<double> bottomRight)
+{
+    auto ring = Geometry::create<Geometry::Type::LinearRing>();
+    ring.add_point(topLeft.x, topLeft.y);
+    ring.add_point(bottomRight.x, topLeft.y);
+    ring.add_point(bottomRight.x, bottomRight.y);
+    ring.add_point(topLeft.x, bottomRight.y);
+    ring.add_point(topLeft.x, topLeft.y);
+    return ring;
+}
+
+TEST_CASE("GdalGeometryTest.rasterizePolygon")
+{
+    // a square with a square hole
+    auto polygon = Geometry::create<Geometry::Type::Polygon>();
+    polygon.add_ring(create_rect_ring(Point(0.25, 3.75), Point(3.75, 0.25)));
+    polygon.add_ring(create_rect_ring(Point(1.25, 2.75), Point(2.75, 1.25)));
+
+    const GeoMetadata meta(4, 4, 0.0, 0.0, 1.0, {});
+
+    SUBCASE("burn")
+    {
+        std::vector<int32_t> data(16, 0);
+        burn_polygon<int32_t>(PolygonCRef(polygon.get()), meta, 5, data);
+        CHECK(data == std::vector<int32_t>({
+                          5, 5, 5, 5,
+                          5, 0, 0, 5,
+                          5, 0, 0, 5,
+                          5, 5, 5, 5,
+                      }));
+    }
+
+    SUBCASE("coverage")
+    {
+        std::vector<float> coverage(16);
+        polygon_coverage(PolygonCRef(polygon.get()), meta, coverage);
+
+        const std::vector<float> expected = {
+            0.5625f, 0.75f, 0.75f, 0.5625f,
+            0.75f, 0.4375f, 0.4375f, 0.75f,
+            0.75f, 0.4375f, 0.4375f, 0.75f,
+            0.5625f, 0.75f, 0.75f, 0.5625f};
+
+        for (size_t i = 0; i < expected.size(); ++i) {
+            CHECK(coverage[i] == doctest::Approx(expected[i]).epsilon(1e-6));
+        }
+    }
+
+    SUBCASE("coverage of a window that only partially overlaps the polygon")
+    {
+        const GeoMetadata window(2, 4, 2.0, 3.0, 1.0, {});
+
+        std::vector<float> coverage(8);
+        polygon_coverage(PolygonCRef(polygon.get()), window, coverage);
+
+        const std::vector<float> expected = {
+            0.0f, 0.0f, 0.0f, 0.0f,
+            0.75f, 0.5625f, 0.0f, 0.0f};
+
+        for (size_t i = 0; i < expected.size(); ++i) {
+            CHECK(coverage[i] == doctest::Approx(expected[i]).epsilon(1e-6));
+        }
+    }
+
+    SUBCASE("multi polygon")
+    {
+        auto multiPolygon = Geometry::create<Geometry::Type::MultiPolygon>();
+        auto first        = Geometry::create<Geometry::Type::Polygon>();
+        first.add_ring(create_rect_ring(Point(0.0, 4.0), Point(1.0, 3.0)));
+        auto second = Geometry::create<Geometry::Type::Polygon>();
+        second.add_ring(create_rect_ring(Point(2.25, 1.0), Point(4.0, 0.0)));
+        multiPolygon.add_geometry(std::move(first));
+        multiPolygon.add_geometry(std::move(second));
+
+        std::vector<uint8_t> data(16, 0);
+        burn_polygon<uint8_t>(MultiPolygonCRef(multiPolygon.get()), meta, 1, data);
+        CHECK(data == std::vector<uint8_t>({
+                          1, 0, 0, 0,
+                          0, 0, 0, 0,
+                          0, 0, 0, 0,
+                          0, 0, 1, 1,
+                      }));
+
+        std::vector<float> coverage(16);
+        polygon_coverage(MultiPolygonCRef(multiPolygon.get()), meta, coverage);
+        CHECK(coverage[0] == doctest::Approx(1.0));
+        CHECK(coverage[14] == doctest::Approx(0.75));
+        CHECK(coverage[15] == doctest::Approx(1.0));
+        CHECK(std::accumulate(coverage.begin(), coverage.end(), 0.0) == doctest::Approx(2.75));
+    }
+
+    SUBCASE("edges through cell centres match gdal rasterize")
+    {
+        // a square and a triangle with vertices on the cell centres
+        auto square = Geometry::create<Geometry::Type::Polygon>();
+        square.add_ring(create_rect_ring(Point(1.5, 3.5), Point(3.5, 1.5)));
+
+        auto triangle = Geometry::create<Geometry::Type::Polygon>();
+        auto ring     = Geometry::create<Geometry::Type::LinearRing>();
+        ring.add_point(0.5, 0.5);
+        ring.add_point(4.5, 0.5);
+        ring.add_point(2.5, 4.5);
+        ring.add_point(0.5, 0.5);
+        triangle.add_ring(std::move(ring));
+
+        const GeoMetadata window(5, 5, 0.0, 0.0, 1.0, {});
+
+        for (auto* polygon : {&square, &triangle}) {
+            auto memDriver = VectorDriver::create(VectorType::Memory);
+            auto ds        = memDriver.create_dataset();
+            auto layer     = ds.create_layer("Polygon", Geometry::Type::Polygon);
+
+            Feature feature(layer.layer_definition());
+            feature.set_geometry(PolygonRef(polygon->get()));
+            layer.create_feature(feature);
+
+            auto expected = rasterize<int32_t>(ds, window, {"-burn", "1"});
+
+            std::vector<int32_t> data(25, 0);
+            burn_polygon<int32_t>(PolygonCRef(polygon->get()), window, 1, data);
+            CHECK(data == expected.second);
+        }
+    }
+
+    SUBCASE("invalid buffer size")
+    {
+        std::vector<float> coverage(10);
+        CHECK_THROWS_AS(polygon_coverage(PolygonCRef(polygon.get()), meta, coverage), InvalidArgument);
+    }
+}
 }
@@ -0,0 +1,883 @@
+#include "infra/gdal.h"
+#include "infra/enumutils.h"
+#include "infra/gdalalgo.h"
+#include "infra/gdalasyncwriter.h"
+#include "infra/gdalchunkreader.h"
+#include "infra/gdalio.h"
+#include "infra/gdalmappedraster.h"
+#include "infra/gdalmetrics.h"
+#include "infra/gdalstatistics.h"
+#include "infra/scopeguard.h"
+#include "infra/test/containerasserts.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <doctest/doctest.h>
+#include <future>
+#include <numeric>
+
+namespace inf::test {
+
+using namespace doctest;
+using namespace std::string_literals;
+
+static GeoMetadata create_test_metadata(int32_t rows, int32_t cols)
+{
+    return GeoMetadata(rows, cols, 1000.0, 2000.0, {100.0, -100.0}, -1.0);
+}
+
+static std::vector<float> create_test_data(int32_t rows, int32_t cols)
+{
+    std::vector<float> data(size_t(rows) * cols);
+    std::iota(data.begin(), data.end(), 0.f);
+    return data;
+}
+
+TEST_CASE("GdalIo.chunkReader")
+{
+    const auto meta = create_test_metadata(50, 20);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    const std::vector<std::string> driverOptions = {"TILED=YES", "BLOCKXSIZE=16", "BLOCKYSIZE=16"};
+    gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/chunks.tif", driverOptions);
+    auto ds = gdal::RasterDataSet::open("/vsimem/chunks.tif");
+
+    SUBCASE("chunks are aligned to the block size")
+    {
+        gdal::io::RasterChunkReader<float> reader(ds, 1, {20, 0});
+        CHECK(reader.chunk_rows() == 32);
+        CHECK(reader.chunk_count() == 2);
+
+        std::vector<float> result;
+        for (auto& chunk : reader) {
+            CHECK(chunk.meta.cols == meta.cols);
+            CHECK(chunk.rowOffset % 32 == 0);
+            result.insert(result.end(), chunk.core_data().begin(), chunk.core_data().end());
+        }
+
+        CHECK_CONTAINER_EQ(data, result);
+    }
+
+    SUBCASE("halo rows")
+    {
+        gdal::io::RasterChunkReader<float> reader(ds, 1, {0, 2});
+        CHECK(reader.chunk_rows() == 16);
+        CHECK(reader.chunk_count() == 4);
+
+        auto first = reader.read_chunk(0);
+        CHECK(first.meta.rows == 20);
+        CHECK(first.meta.top_left() == Point(meta.top_left().x, meta.top_left().y + 200.0));
+        CHECK(first.data[0] == -1.f);
+        CHECK(first.core_data()[0] == 0.f);
+
+        auto last = reader.read_chunk(3);
+        CHECK(last.rows == 2);
+        CHECK(last.meta.rows == 6);
+        CHECK(last.data[0] == data[46 * meta.cols]);
+        CHECK(last.data.back() == -1.f);
+    }
+}
+
+TEST_CASE("GdalIo.parallelRead")
+{
+    const auto meta = create_test_metadata(50, 20);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    const std::vector<std::string> driverOptions = {"TILED=YES", "BLOCKXSIZE=16", "BLOCKYSIZE=16"};
+    gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/parallel.tif", driverOptions);
+
+    gdal::io::ParallelReadOptions options;
+    options.threadCount = 3;
+
+    SUBCASE("full raster")
+    {
+        std::vector<float> result(data.size());
+        auto resultMeta = gdal::io::read_raster_data_parallel<float>("/vsimem/parallel.tif", 1, result, options);
+        CHECK(resultMeta == meta);
+        CHECK_CONTAINER_EQ(data, result);
+    }
+
+    SUBCASE("extent exceeding the raster")
+    {
+        auto extent = meta;
+        extent.rows += 10;
+        extent.cols += 2;
+        extent.xll -= 100.0;
+        extent.yll -= 500.0;
+
+        std::vector<float> expected(size_t(extent.rows) * extent.cols);
+        auto ds           = gdal::RasterDataSet::open("/vsimem/parallel.tif");
+        auto expectedMeta = gdal::io::read_raster_data<float>(ds, extent, 1, expected);
+
+        std::vector<float> result(expected.size());
+        auto resultMeta = gdal::io::read_raster_data_parallel<float>("/vsimem/parallel.tif", extent, 1, result, options);
+        CHECK(resultMeta == expectedMeta);
+        CHECK_CONTAINER_EQ(expected, result);
+    }
+}
+
+TEST_CASE("GdalIo.writeConverted")
+{
+    const auto meta = create_test_metadata(50, 20);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    std::vector<double> doubleData(data.begin(), data.end());
+    doubleData[5] = 1.25;
+
+    SUBCASE("driver that supports create")
+    {
+        const std::vector<std::string> driverOptions = {"TILED=YES", "BLOCKXSIZE=16", "BLOCKYSIZE=16"};
+        gdal::io::write_raster_as<int32_t, double>(doubleData, meta, "/vsimem/converted.tif", driverOptions, {{"key", "value"}});
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/converted.tif");
+        CHECK(ds.band_datatype(1) == typeid(int32_t));
+        CHECK(ds.metadata_item("key") == "value");
+
+        std::vector<int32_t> result(data.size());
+        auto resultMeta = gdal::io::read_raster_data<int32_t>(ds, result);
+        CHECK(resultMeta == meta);
+        CHECK(result[5] == 1);
+        CHECK(result.back() == int32_t(data.back()));
+    }
+
+    SUBCASE("driver that only supports create copy")
+    {
+        gdal::io::write_raster_as<float, double>(doubleData, meta, "/vsimem/converted.asc");
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/converted.asc");
+        std::vector<float> result(data.size());
+        gdal::io::read_raster_data<float>(ds, result);
+        CHECK(result[5] == 1.25f);
+        CHECK(result.back() == data.back());
+    }
+
+    SUBCASE("values are rounded and clamped")
+    {
+        auto floatData = data;
+        floatData[0]   = 2.7f;
+        floatData[1]   = -2.7f;
+        floatData[2]   = std::numeric_limits<float>::quiet_NaN();
+        floatData[3]   = -1e10f;
+
+        gdal::io::write_raster_as<int32_t, float>(floatData, meta, "/vsimem/converted_rounded.tif");
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/converted_rounded.tif");
+        std::vector<int32_t> result(data.size());
+        gdal::io::read_raster_data<int32_t>(ds, result);
+        CHECK(result[0] == 3);
+        CHECK(result[1] == -3);
+        CHECK(result[2] == 0);
+        CHECK(result[3] == std::numeric_limits<int32_t>::min());
+    }
+
+    SUBCASE("both driver kinds use the same conversion")
+    {
+        auto floatData = data;
+        floatData[0]   = 1.7f;
+        floatData[1]   = -1.7f;
+        floatData[2]   = 3.2f;
+        floatData[3]   = 1e10f;
+
+        gdal::io::write_raster(std::span<const float>(floatData), meta, "/vsimem/converted_create.tif", typeid(int32_t));
+        gdal::io::write_raster(std::span<const float>(floatData), meta, "/vsimem/converted_create_copy.asc", typeid(int32_t));
+
+        auto createDs     = gdal::RasterDataSet::open("/vsimem/converted_create.tif");
+        auto createCopyDs = gdal::RasterDataSet::open("/vsimem/converted_create_copy.asc");
+
+        std::vector<int32_t> createResult(data.size()), createCopyResult(data.size());
+        gdal::io::read_raster_data<int32_t>(createDs, createResult);
+        gdal::io::read_raster_data<int32_t>(createCopyDs, createCopyResult);
+
+        CHECK(createResult == createCopyResult);
+        CHECK(createResult[0] == 2);
+        CHECK(createResult[1] == -2);
+        CHECK(createResult[2] == 3);
+        CHECK(createResult[3] == std::numeric_limits<int32_t>::max());
+    }
+}
+
+TEST_CASE("GdalIo.asyncWriter")
+{
+    const auto meta = create_test_metadata(50, 20);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    gdal::io::AsyncRasterWriter writer(2, data.size() * sizeof(float) * 2);
+
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < 4; ++i) {
+        results.push_back(writer.write_raster(data, meta, fmt::format("/vsimem/async{}.tif", i)));
+        CHECK(writer.in_flight_bytes() <= writer.max_in_flight_bytes());
+    }
+
+    auto shared = std::make_shared<const std::vector<float>>(data);
+    results.push_back(writer.write_raster(shared, meta, "/vsimem/async_int.tif", typeid(int32_t)));
+
+    for (auto& result : results) {
+        CHECK_NOTHROW(result.get());
+    }
+
+    writer.wait_until_finished();
+    CHECK(writer.queue_depth() == 0);
+    CHECK(writer.in_flight_bytes() == 0);
+
+    for (int i = 0; i < 4; ++i) {
+        auto ds = gdal::RasterDataSet::open(fmt::format("/vsimem/async{}.tif", i));
+        std::vector<float> result(data.size());
+        gdal::io::read_raster_data<float>(ds, result);
+        CHECK_CONTAINER_EQ(data, result);
+    }
+
+    CHECK(gdal::RasterDataSet::open("/vsimem/async_int.tif").band_datatype(1) == typeid(int32_t));
+
+    SUBCASE("errors are reported through the future")
+    {
+        auto result = writer.write_raster(data, meta, "/vsimem/async.unknownextension");
+        CHECK_THROWS(result.get());
+    }
+}
+
+TEST_CASE("GdalIo.asyncWriterByteLimit")
+{
+    gdal::io::AsyncRasterWriter writer(2, 100);
+
+    std::promise<void> release;
+    auto released  = release.get_future().share();
+    auto slowWrite = writer.submit(100, [released]() { released.wait(); });
+
+    auto submitter = std::async(std::launch::async, [&writer]() {
+        return writer.submit(50, []() {});
+    });
+
+    // the second write does not fit before the slow write releases its bytes, even though a thread is available
+    CHECK(submitter.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+    CHECK(writer.in_flight_bytes() == 100);
+    CHECK(writer.queue_depth() == 1);
+
+    release.set_value();
+    CHECK_NOTHROW(slowWrite.get());
+    CHECK_NOTHROW(submitter.get().get());
+
+    writer.wait_until_finished();
+    CHECK(writer.in_flight_bytes() == 0);
+}
+
+TEST_CASE("GdalIo.resampledRead")
+{
+    const auto meta = create_test_metadata(64, 64);
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    for (int32_t row = 0; row < meta.rows; ++row) {
+        std::fill_n(data.begin() + size_t(row) * meta.cols, meta.cols, float(row));
+    }
+
+    gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/resample.tif");
+
+    auto extent     = meta;
+    extent.rows     = 16;
+    extent.cols     = 16;
+    extent.cellSize = GeoMetadata::CellSize(400.0, -400.0);
+
+    std::vector<float> expected(size_t(extent.rows) * extent.cols);
+    for (int32_t row = 0; row < extent.rows; ++row) {
+        std::fill_n(expected.begin() + size_t(row) * extent.cols, extent.cols, row * 4 + 1.5f);
+    }
+
+    SUBCASE("decimating read without overviews")
+    {
+        auto ds = gdal::RasterDataSet::open("/vsimem/resample.tif");
+        std::vector<float> result(expected.size());
+        auto resultMeta = gdal::io::read_raster_data_resampled<float>(ds, extent, 1, result, gdal::ResampleAlgorithm::Average);
+        CHECK(resultMeta.rows == extent.rows);
+        CHECK(resultMeta.cols == extent.cols);
+        CHECK(resultMeta.cellSize == extent.cellSize);
+        CHECK_CONTAINER_EQ(expected, result);
+    }
+
+    SUBCASE("read from overview")
+    {
+        {
+            auto ds = gdal::RasterDataSet::open_for_writing("/vsimem/resample.tif");
+            const std::array<int32_t, 2> levels = {2, 4};
+            ds.build_overviews(gdal::ResampleAlgorithm::Average, levels);
+        }
+
+        // the overview already contains the averages, nearest neighbour returns the overview values
+        auto ds = gdal::RasterDataSet::open("/vsimem/resample.tif");
+        std::vector<float> result(expected.size());
+        gdal::io::read_raster_data_resampled<float>(ds, extent, 1, result, gdal::ResampleAlgorithm::NearestNeighbour);
+        CHECK_CONTAINER_EQ(expected, result);
+    }
+
+    SUBCASE("extent outside of the raster")
+    {
+        auto shiftedExtent = extent;
+        shiftedExtent.xll -= 800.0;
+        shiftedExtent.yll += 800.0;
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/resample.tif");
+        std::vector<float> result(expected.size());
+        gdal::io::read_raster_data_resampled<float>(ds, shiftedExtent, 1, result, gdal::ResampleAlgorithm::Average);
+
+        // the first two rows and columns are outside of the raster
+        CHECK(result[0] == -1.f);
+        CHECK(result[1 * extent.cols + 5] == -1.f);
+        CHECK(result[2 * extent.cols + 1] == -1.f);
+        CHECK(result[2 * extent.cols + 2] == 1.5f);
+        CHECK(result.back() == 13 * 4 + 1.5f);
+    }
+
+    SUBCASE("same cell size")
+    {
+        auto ds = gdal::RasterDataSet::open("/vsimem/resample.tif");
+        std::vector<float> result(data.size());
+        gdal::io::read_raster_data_resampled<float>(ds, meta, 1, result, gdal::ResampleAlgorithm::Bilinear);
+        CHECK_CONTAINER_EQ(data, result);
+    }
+}
+
+TEST_CASE("GdalIo.mappedRaster")
+{
+    const auto meta = create_test_metadata(50, 20);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    const std::vector<std::string> uncompressed = {"COMPRESS=NONE"};
+
+    SUBCASE("uncompressed stripped tiff is mapped")
+    {
+        const auto path = fs::temp_directory_path() / "mapped.tif";
+        gdal::io::write_raster(std::span<const float>(data), meta, path, uncompressed);
+
+        auto mapped = gdal::MappedRaster<float>::open(path);
+        if (CPLIsVirtualMemFileMapAvailable()) {
+            CHECK(mapped.is_mapped());
+        }
+
+        CHECK(mapped.metadata() == meta);
+        CHECK_CONTAINER_EQ(data, mapped.data());
+        CHECK(mapped.row(3)[5] == data[3 * meta.cols + 5]);
+    }
+
+    SUBCASE("compressed tiff falls back to reading")
+    {
+        gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/mapped.tif");
+
+        auto mapped = gdal::MappedRaster<float>::open("/vsimem/mapped.tif");
+        CHECK_FALSE(mapped.is_mapped());
+        CHECK(mapped.metadata() == meta);
+        CHECK_CONTAINER_EQ(data, mapped.data());
+    }
+
+    SUBCASE("different type falls back to reading")
+    {
+        const auto path = fs::temp_directory_path() / "mapped.tif";
+        gdal::io::write_raster(std::span<const float>(data), meta, path, uncompressed);
+
+        auto mapped = gdal::MappedRaster<int32_t>::open(path);
+        CHECK_FALSE(mapped.is_mapped());
+
+        std::vector<int32_t> expected(data.begin(), data.end());
+        CHECK_CONTAINER_EQ(expected, mapped.data());
+    }
+}
+
+TEST_CASE("GdalIo.readByteWithNodataOutOfRange")
+{
+    // large enough to be converted in multiple strips
+    const auto meta = create_test_metadata(1000, 2100);
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i % 11 == 0) ? -1.f : float(i % 200);
+    }
+
+    gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/bytenodata.tif");
+
+    std::vector<uint8_t> expected(data.size());
+    std::transform(data.begin(), data.end(), expected.begin(), [](float value) {
+        return value == -1.f ? std::numeric_limits<uint8_t>::max() : uint8_t(value);
+    });
+
+    SUBCASE("full extent")
+    {
+        auto ds = gdal::RasterDataSet::open("/vsimem/bytenodata.tif");
+        std::vector<uint8_t> result(data.size());
+        auto resultMeta = gdal::io::read_raster_data<uint8_t>(ds, std::span<uint8_t>(result));
+        CHECK(resultMeta.nodata == 255.0);
+        CHECK_CONTAINER_EQ(expected, result);
+    }
+
+    SUBCASE("extent partially outside of the raster")
+    {
+        auto extent = meta;
+        extent.yll -= 300 * 100.0;
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/bytenodata.tif");
+        std::vector<uint8_t> result(data.size());
+        auto resultMeta = gdal::io::read_raster_data<uint8_t>(ds, extent, std::span<uint8_t>(result));
+        CHECK(resultMeta.nodata == 255.0);
+
+        // the extent starts 300 rows below the top of the raster, its bottom rows are outside of the raster
+        const auto offset = size_t(300) * meta.cols;
+        CHECK(std::equal(expected.begin() + offset, expected.end(), result.begin()));
+        CHECK(std::all_of(result.end() - offset, result.end(), [](uint8_t value) { return value == 255; }));
+    }
+}
+
+TEST_CASE("GdalIo.statistics")
+{
+    const auto meta = create_test_metadata(50, 20);
+    auto data       = create_test_data(meta.rows, meta.cols);
+    for (size_t i = 0; i < data.size(); i += 9) {
+        data[i] = -1.f;
+    }
+
+    const std::vector<std::string> driverOptions = {"TILED=YES", "BLOCKXSIZE=16", "BLOCKYSIZE=16"};
+    gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/statistics.tif", driverOptions);
+
+    StatisticsOptions options;
+    options.threadCount = 4;
+
+    SUBCASE("full band matches the gdal statistics")
+    {
+        auto stats = gdal::compute_statistics("/vsimem/statistics.tif", 1, options);
+
+        auto gdalStats = gdal::RasterDataSet::open("/vsimem/statistics.tif").statistics(1, false, true);
+        CHECK(stats.min == gdalStats.min);
+        CHECK(stats.max == gdalStats.max);
+        CHECK(stats.mean == Approx(gdalStats.mean));
+        CHECK(stats.stddev == Approx(gdalStats.stddev));
+        CHECK(stats.count + stats.nodataCount == data.size());
+    }
+
+    SUBCASE("extent and mask")
+    {
+        // the extent covers the bottom 10 rows of the raster and 10 rows below it
+        auto extent = meta;
+        extent.rows = 20;
+        extent.yll -= 10 * 100.0;
+
+        std::vector<uint8_t> mask(size_t(extent.rows) * extent.cols, 1);
+        mask[0] = 0;
+
+        auto stats = gdal::compute_statistics("/vsimem/statistics.tif", 1, extent, mask, options);
+
+        StatisticsAccumulator accumulator(options);
+        accumulator.add(std::span<const float>(data).subspan(size_t(40) * meta.cols + 1), meta.nodata);
+        auto expected = accumulator.result();
+        CHECK(stats.count == expected.count);
+        CHECK(stats.min == expected.min);
+        CHECK(stats.max == expected.max);
+        CHECK(stats.mean == Approx(expected.mean));
+    }
+
+    SUBCASE("float nodata that is not representable as float")
+    {
+        auto floatMeta   = meta;
+        floatMeta.nodata = 0.1;
+
+        auto floatData = data;
+        std::replace(floatData.begin(), floatData.end(), -1.f, 0.1f);
+        gdal::io::write_raster(std::span<const float>(floatData), floatMeta, "/vsimem/statistics_nodata.tif", driverOptions);
+
+        auto stats = gdal::compute_statistics("/vsimem/statistics_nodata.tif", 1, options);
+
+        StatisticsAccumulator accumulator(options);
+        accumulator.add(std::span<const float>(data), meta.nodata);
+        auto expected = accumulator.result();
+        CHECK(stats.count == expected.count);
+        CHECK(stats.nodataCount == expected.nodataCount);
+        CHECK(stats.min == expected.min);
+        CHECK(stats.mean == Approx(expected.mean));
+    }
+}
+
+TEST_CASE("GdalIo.writeTiled")
+{
+    const auto meta = create_test_metadata(100, 70);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    gdal::io::TiledWriteOptions options;
+    options.tileSize    = 32;
+    options.threadCount = 4;
+
+    SUBCASE("same type")
+    {
+        options.compression = gdal::io::TiffCompression::Deflate;
+        gdal::io::write_raster_tiled(std::span<const float>(data), meta, "/vsimem/tiled.tif", options);
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/tiled.tif");
+        CHECK(ds.rasterband(1).block_size() == Size(32, 32));
+        CHECK(ds.metadata_item("COMPRESSION", "IMAGE_STRUCTURE") == "DEFLATE");
+
+        std::vector<float> result(data.size());
+        auto resultMeta = gdal::io::read_raster_data<float>(ds, std::span<float>(result));
+        CHECK(resultMeta == meta);
+        CHECK_CONTAINER_EQ(data, result);
+    }
+
+    SUBCASE("converted storage type")
+    {
+        options.compression = gdal::io::TiffCompression::Lzw;
+        gdal::io::write_raster_tiled<int32_t>(std::span<const float>(data), meta, "/vsimem/tiled.tif", options);
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/tiled.tif");
+        CHECK(ds.band_datatype(1) == typeid(int32_t));
+
+        std::vector<int32_t> result(data.size());
+        gdal::io::read_raster_data<int32_t>(ds, std::span<int32_t>(result));
+
+        std::vector<int32_t> expected(data.begin(), data.end());
+        CHECK_CONTAINER_EQ(expected, result);
+    }
+
+    SUBCASE("converted storage type matches write_raster")
+    {
+        auto floatData = data;
+        floatData[0]   = 1.7f;
+        floatData[1]   = -1.7f;
+        floatData[2]   = std::numeric_limits<float>::quiet_NaN();
+        floatData[3]   = 1e10f;
+
+        gdal::io::write_raster_tiled<int32_t>(std::span<const float>(floatData), meta, "/vsimem/tiled.tif", options);
+        gdal::io::write_raster(std::span<const float>(floatData), meta, "/vsimem/tiled_reference.tif", typeid(int32_t));
+
+        auto ds          = gdal::RasterDataSet::open("/vsimem/tiled.tif");
+        auto referenceDs = gdal::RasterDataSet::open("/vsimem/tiled_reference.tif");
+
+        std::vector<int32_t> result(data.size()), expected(data.size());
+        gdal::io::read_raster_data<int32_t>(ds, std::span<int32_t>(result));
+        gdal::io::read_raster_data<int32_t>(referenceDs, std::span<int32_t>(expected));
+        CHECK_CONTAINER_EQ(expected, result);
+        CHECK(result[0] == 2);
+        CHECK(result[1] == -2);
+        CHECK(result[2] == 0);
+        CHECK(result[3] == std::numeric_limits<int32_t>::max());
+    }
+
+    SUBCASE("unsigned storage type with negative nodata")
+    {
+        CHECK_THROWS_AS(gdal::io::write_raster_tiled<uint8_t>(std::span<const float>(data), meta, "/vsimem/tiled.tif", options), RuntimeError);
+    }
+
+    SUBCASE("invalid tile size")
+    {
+        options.tileSize = 20;
+        CHECK_THROWS_AS(gdal::io::write_raster_tiled(std::span<const float>(data), meta, "/vsimem/tiled.tif", options), InvalidArgument);
+    }
+}
+
+TEST_CASE("GdalIo.writeCog")
+{
+    const auto meta = create_test_metadata(500, 600);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    gdal::io::CogWriteOptions options;
+    options.tileSize           = 128;
+    options.overviewResampling = gdal::ResampleAlgorithm::Average;
+
+    gdal::io::write_raster_cog(std::span<const float>(data), meta, "/vsimem/cog.tif", options);
+
+    auto ds = gdal::RasterDataSet::open("/vsimem/cog.tif");
+    CHECK(ds.metadata_item("LAYOUT", "IMAGE_STRUCTURE") == "COG");
+    CHECK(ds.rasterband(1).block_size() == Size(128, 128));
+    // 300x250, 150x125 and 75x63, the last overview fits in a tile
+    CHECK(ds.rasterband(1).overview_count() == 3);
+
+    std::vector<float> result(data.size());
+    gdal::io::read_raster_data<float>(ds, std::span<float>(result));
+    CHECK_CONTAINER_EQ(data, result);
+
+    // the first overview contains the averages of 2x2 cells
+    auto extent     = meta;
+    extent.rows     = 250;
+    extent.cols     = 300;
+    extent.cellSize = GeoMetadata::CellSize(200.0, -200.0);
+
+    std::vector<float> overview(size_t(extent.rows) * extent.cols);
+    gdal::io::read_raster_data_resampled<float>(ds, extent, std::span<float>(overview));
+    CHECK(overview[0] == Approx(0.5 * meta.cols + 0.5));
+    CHECK(overview[extent.cols + 1] == Approx(2.5 * meta.cols + 2.5));
+}
+
+TEST_CASE("GdalIo.writeCogConverted")
+{
+    const auto meta = create_test_metadata(256, 256);
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = float(i % 7) - 2.3f;
+    }
+    data[1] = 1e10f;
+
+    gdal::io::CogWriteOptions options;
+    options.tileSize = 64;
+
+    gdal::io::write_raster_cog<int32_t>(std::span<const float>(data), meta, "/vsimem/cog_converted.tif", options);
+    gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/cog_reference.tif", typeid(int32_t));
+
+    auto ds          = gdal::RasterDataSet::open("/vsimem/cog_converted.tif");
+    auto referenceDs = gdal::RasterDataSet::open("/vsimem/cog_reference.tif");
+    CHECK(ds.band_datatype(1) == typeid(int32_t));
+    CHECK(ds.metadata_item("LAYOUT", "IMAGE_STRUCTURE") == "COG");
+    CHECK(ds.rasterband(1).overview_count() == 2);
+
+    // the conversion rounds and clamps, as write_raster does
+    std::vector<int32_t> result(data.size()), expected(data.size());
+    gdal::io::read_raster_data<int32_t>(ds, std::span<int32_t>(result));
+    gdal::io::read_raster_data<int32_t>(referenceDs, std::span<int32_t>(expected));
+    CHECK_CONTAINER_EQ(expected, result);
+    CHECK(result[0] == -2);
+    CHECK(result[1] == std::numeric_limits<int32_t>::max());
+    CHECK(result[4] == 2);
+
+    CHECK_THROWS_AS(gdal::io::write_raster_cog<uint8_t>(std::span<const float>(data), meta, "/vsimem/cog_unsigned.tif", options), RuntimeError);
+}
+
+TEST_CASE("GdalIo.metrics")
+{
+    const auto meta = create_test_metadata(20, 30);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    auto& metrics = gdal::IoMetrics::instance();
+    metrics.reset();
+    gdal::IoMetrics::set_enabled(true);
+    ScopeGuard disableMetrics([&metrics]() {
+        gdal::IoMetrics::set_enabled(false);
+        metrics.reset();
+    });
+
+    auto driver = gdal::RasterDriver::create(gdal::RasterType::GeoTiff);
+    auto ds     = driver.create_dataset<float>(meta.rows, meta.cols, 1, "/vsimem/metrics.tif");
+    ds.write_rasterdata(1, 0, 0, meta.cols, meta.rows, data.data(), meta.cols, meta.rows);
+
+    std::vector<float> result(data.size());
+    ds.read_rasterdata(1, 0, 0, meta.cols, meta.rows, result.data(), meta.cols, meta.rows);
+    ds.read_rasterdata(1, 0, 0, meta.cols, meta.rows, result.data(), meta.cols / 2, meta.rows / 2);
+
+    auto datasets = metrics.datasets();
+    REQUIRE(datasets.size() == 1);
+    CHECK(datasets.front().name == "/vsimem/metrics.tif");
+
+    auto& reads = datasets.front().operations[enum_value(gdal::IoOperation::Read)];
+    CHECK(reads.calls == 2);
+    CHECK(reads.bytes == (data.size() + data.size() / 4) * sizeof(float));
+
+    auto& writes = datasets.front().operations[enum_value(gdal::IoOperation::Write)];
+    CHECK(writes.calls == 1);
+    CHECK(writes.bytes == data.size() * sizeof(float));
+
+    CHECK(metrics.totals()[enum_value(gdal::IoOperation::Read)].calls == 2);
+    CHECK(metrics.to_json().find(R"("name":"/vsimem/metrics.tif")") != std::string::npos);
+
+    SUBCASE("translate")
+    {
+        metrics.reset();
+        gdal::translate<float>(ds, meta);
+
+        auto translated = metrics.datasets();
+        REQUIRE(translated.size() == 1);
+
+        auto& operations = translated.front().operations;
+        CHECK(operations[enum_value(gdal::IoOperation::Translate)].calls == 1);
+        CHECK(operations[enum_value(gdal::IoOperation::Translate)].bytes == data.size() * sizeof(float));
+        CHECK(operations[enum_value(gdal::IoOperation::Warp)].calls == 0);
+    }
+
+    SUBCASE("disabled")
+    {
+        metrics.reset();
+        gdal::IoMetrics::set_enabled(false);
+        ds.read_rasterdata(1, 0, 0, meta.cols, meta.rows, result.data(), meta.cols, meta.rows);
+        CHECK(metrics.datasets().empty());
+    }
+}
+
+TEST_CASE("GdalIo.rasterView")
+{
+    const auto meta = create_test_metadata(10, 20);
+    auto data       = create_test_data(meta.rows, meta.cols);
+    data[5]         = -1.f;
+
+    std::vector<uint8_t> result(data.size());
+
+    SUBCASE("type conversion")
+    {
+        auto view = gdal::io::create_raster_view<uint8_t>(std::span<const float>(data), meta);
+        REQUIRE(view.dataset().band_datatype(1) == typeid(uint8_t));
+        CHECK(view.dataset().geometadata().cellSize == meta.cellSize);
+
+        view.dataset().read_rasterdata<uint8_t>(1, 0, 0, meta.cols, meta.rows, result.data(), meta.cols, meta.rows);
+        CHECK(result[0] == 0);
+        CHECK(result[5] == 0); // clamped
+        CHECK(result[199] == 199);
+    }
+
+    SUBCASE("scale and nodata remap")
+    {
+        gdal::io::RasterViewOptions options;
+        options.scale  = 0.5;
+        options.offset = 10.0;
+        options.nodata = 255.0;
+
+        auto view = gdal::io::create_raster_view<uint8_t>(std::span<const float>(data), meta, options);
+        CHECK(view.dataset().nodata_value(1) == 255.0);
+
+        view.dataset().read_rasterdata<uint8_t>(1, 0, 0, meta.cols, meta.rows, result.data(), meta.cols, meta.rows);
+        CHECK(result[0] == 10);
+        CHECK(result[5] == 255);
+        CHECK(result[10] == 15);
+        CHECK(result[199] == 110);
+    }
+
+    SUBCASE("write converted with a create copy driver")
+    {
+        auto pngMeta   = meta;
+        pngMeta.nodata = 255.0;
+        data[5]        = 5.f;
+
+        gdal::io::write_raster(std::span<const float>(data), pngMeta, "/vsimem/view.png", typeid(uint8_t));
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/view.png");
+        REQUIRE(ds.band_datatype(1) == typeid(uint8_t));
+        ds.read_rasterdata<uint8_t>(1, 0, 0, meta.cols, meta.rows, result.data(), meta.cols, meta.rows);
+        for (size_t i = 0; i < result.size(); ++i) {
+            CHECK(result[i] == uint8_t(i));
+        }
+    }
+
+    SUBCASE("invalid buffer size")
+    {
+        CHECK_THROWS_AS(gdal::io::create_raster_view<uint8_t>(std::span<const float>(data).subspan(1), meta), InvalidArgument);
+    }
+}
+
+TEST_CASE("GdalIo.batchRead")
+{
+    const auto meta = create_test_metadata(50, 40);
+    const auto data = create_test_data(meta.rows, meta.cols);
+
+    const std::vector<std::string> driverOptions = {"TILED=YES", "BLOCKXSIZE=16", "BLOCKYSIZE=16"};
+    gdal::io::write_raster(std::span<const float>(data), meta, "/vsimem/batch.tif", driverOptions);
+    auto ds = gdal::RasterDataSet::open("/vsimem/batch.tif");
+
+    auto create_extent = [&](int32_t row, int32_t col, int32_t rows, int32_t cols) {
+        auto extent = meta;
+        extent.rows = rows;
+        extent.cols = cols;
+        extent.xll  = meta.xll + col * meta.cellSize.x;
+        extent.yll  = meta.yll + (meta.rows - row - rows) * std::abs(meta.cellSize.y);
+        return extent;
+    };
+
+    const std::vector<GeoMetadata> extents = {
+        create_extent(0, 0, 5, 5),
+        create_extent(2, 3, 5, 5),     // overlaps the first extent
+        create_extent(20, 20, 10, 10), // spans multiple blocks
+        create_extent(-3, -2, 6, 6),   // partially outside of the raster
+        create_extent(45, 35, 10, 10), // partially outside of the raster
+        create_extent(100, 100, 4, 4), // outside of the raster
+        create_extent(0, 0, 50, 40),   // the full raster
+    };
+
+    SUBCASE("float")
+    {
+        std::vector<std::vector<float>> batchData;
+        std::vector<std::span<float>> buffers;
+        for (auto& extent : extents) {
+            batchData.emplace_back(size_t(extent.rows) * extent.cols);
+        }
+
+        for (auto& buffer : batchData) {
+            buffers.emplace_back(buffer);
+        }
+
+        auto batchMeta = gdal::io::read_raster_data_batch<float>(ds, extents, buffers);
+        REQUIRE(batchMeta.size() == extents.size());
+
+        for (size_t i = 0; i < extents.size(); ++i) {
+            std::vector<float> expected(batchData[i].size());
+            auto expectedMeta = gdal::io::read_raster_data<float>(ds, extents[i], std::span<float>(expected));
+            CHECK(batchMeta[i] == expectedMeta);
+            CHECK_CONTAINER_EQ(batchData[i], expected);
+        }
+    }
+
+    SUBCASE("byte with nodata that does not fit")
+    {
+        std::vector<std::vector<uint8_t>> batchData;
+        std::vector<std::span<uint8_t>> buffers;
+        for (auto& extent : extents) {
+            batchData.emplace_back(size_t(extent.rows) * extent.cols);
+        }
+
+        for (auto& buffer : batchData) {
+            buffers.emplace_back(buffer);
+        }
+
+        auto batchMeta = gdal::io::read_raster_data_batch<uint8_t>(ds, extents, buffers);
+        for (size_t i = 0; i < extents.size(); ++i) {
+            std::vector<uint8_t> expected(batchData[i].size());
+            auto expectedMeta = gdal::io::read_raster_data<uint8_t>(ds, extents[i], std::span<uint8_t>(expected));
+            CHECK(batchMeta[i] == expectedMeta);
+            CHECK_CONTAINER_EQ(batchData[i], expected);
+        }
+    }
+
+    SUBCASE("invalid buffers")
+    {
+        std::vector<float> buffer(25);
+        std::vector<std::span<float>> buffers = {std::span<float>(buffer)};
+        CHECK_THROWS_AS(gdal::io::read_raster_data_batch<float>(ds, std::span<const GeoMetadata>(extents).subspan(1, 2), buffers), InvalidArgument);
+        CHECK_THROWS_AS(gdal::io::read_raster_data_batch<float>(ds, std::span<const GeoMetadata>(extents).subspan(2, 1), buffers), InvalidArgument);
+    }
+}
+
+TEST_CASE("GdalIo.groupCutouts")
+{
+    // a grid of 100x100 windows of 4x4 cells, 4 windows per block of 8x8 cells
+    std::vector<gdal::io::CutOut> cutOuts;
+    for (int row = 0; row < 100; ++row) {
+        for (int col = 0; col < 100; ++col) {
+            gdal::io::CutOut cutOut;
+            cutOut.srcRowOffset = row * 4;
+            cutOut.srcColOffset = col * 4;
+            cutOut.rows         = 4;
+            cutOut.cols         = 4;
+            cutOuts.push_back(cutOut);
+        }
+    }
+
+    auto checkMembers = [&](const std::vector<gdal::io::detail::BatchReadGroup>& groups) {
+        std::vector<int> memberCount(cutOuts.size(), 0);
+        for (auto& group : groups) {
+            for (auto index : group.members) {
+                ++memberCount[index];
+                CHECK(cutOuts[index].srcColOffset >= group.colOffset);
+                CHECK(cutOuts[index].srcRowOffset >= group.rowOffset);
+                CHECK(cutOuts[index].srcColOffset + cutOuts[index].cols <= group.colOffset + group.cols);
+                CHECK(cutOuts[index].srcRowOffset + cutOuts[index].rows <= group.rowOffset + group.rows);
+            }
+        }
+
+        CHECK(std::all_of(memberCount.begin(), memberCount.end(), [](int count) { return count == 1; }));
+    };
+
+    SUBCASE("all windows fit in a single group")
+    {
+        auto groups = gdal::io::detail::group_cutouts(cutOuts, Size(8, 8));
+        REQUIRE(groups.size() == 1);
+        CHECK(groups.front().cols == 400);
+        CHECK(groups.front().rows == 400);
+        checkMembers(groups);
+    }
+
+    SUBCASE("groups are limited to the maximum number of cells")
+    {
+        auto groups = gdal::io::detail::group_cutouts(cutOuts, Size(8, 8), 64);
+        CHECK(groups.size() == 2500);
+        for (auto& group : groups) {
+            CHECK(group.members.size() == 4);
+        }
+        checkMembers(groups);
+    }
+}
+
+}
@@ -0,0 +1,212 @@
+#include "infra/gdalio.h"
+#include "infra/gdalmosaic.h"
+#include "infra/tempdir.h"
+#include "infra/test/containerasserts.h"
+
+#include <doctest/doctest.h>
+#include <fmt/format.h>
+#include <numeric>
+
+namespace inf::test {
+
+using namespace doctest;
+
+TEST_CASE("Gdal.rasterMosaic")
+{
+    // a raster of 30x40 cells, stored as tiles of 10x10 cells
+    const GeoMetadata meta(30, 40, 1000.0, 2000.0, GeoMetadata::CellSize(100.0, -100.0), -1.0);
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    std::iota(data.begin(), data.end(), 0.f);
+
+    std::vector<fs::path> tilePaths;
+    for (int32_t tileRow = 0; tileRow < 3; ++tileRow) {
+        for (int32_t tileCol = 0; tileCol < 4; ++tileCol) {
+            if (tileRow == 1 && tileCol == 1) {
+                continue; // leave a gap in the mosaic
+            }
+
+            auto tileMeta = meta;
+            tileMeta.rows = 10;
+            tileMeta.cols = 10;
+            tileMeta.xll  = meta.xll + tileCol * 1000.0;
+            tileMeta.yll  = meta.yll + (2 - tileRow) * 1000.0;
+
+            std::vector<float> tileData;
+            for (int32_t r = 0; r < 10; ++r) {
+                auto rowStart = data.begin() + (tileRow * 10 + r) * meta.cols + tileCol * 10;
+                tileData.insert(tileData.end(), rowStart, rowStart + 10);
+            }
+
+            tilePaths.push_back(fmt::format("/vsimem/mosaic_{}_{}.tif", tileRow, tileCol));
+            gdal::io::write_raster(std::span<const float>(tileData), tileMeta, tilePaths.back());
+        }
+    }
+
+    auto mosaic = gdal::RasterMosaic::create(tilePaths);
+    CHECK(mosaic.tiles().size() == 11);
+    CHECK(mosaic.metadata().rows == meta.rows);
+    CHECK(mosaic.metadata().cols == meta.cols);
+    CHECK(mosaic.metadata().xll == meta.xll);
+    CHECK(mosaic.metadata().yll == meta.yll);
+
+    auto expectedData = [&](const GeoMetadata& extent) {
+        std::vector<float> expected(size_t(extent.rows) * extent.cols, -1.f);
+        for (int32_t r = 0; r < extent.rows; ++r) {
+            for (int32_t c = 0; c < extent.cols; ++c) {
+                auto point = extent.convert_cell_centre_to_xy(Cell(r, c));
+                auto cell  = meta.convert_xy_to_cell(point.x, point.y);
+                if (meta.is_on_map(cell) && !(cell.r >= 10 && cell.r < 20 && cell.c >= 10 && cell.c < 20)) {
+                    expected[size_t(r) * extent.cols + c] = data[size_t(cell.r) * meta.cols + cell.c];
+                }
+            }
+        }
+
+        return expected;
+    };
+
+    SUBCASE("intersecting tiles")
+    {
+        auto extent = meta;
+        extent.rows = 5;
+        extent.cols = 5;
+        extent.xll += 800.0;
+        extent.yll += 2300.0;
+        CHECK(mosaic.intersecting_tiles(extent.bounding_box()) == std::vector<size_t>{0, 1});
+    }
+
+    SUBCASE("read extent")
+    {
+        // covers the gap and extends outside of the mosaic
+        auto extent = meta;
+        extent.rows = 25;
+        extent.cols = 25;
+        extent.xll -= 500.0;
+        extent.yll += 800.0;
+
+        std::vector<float> result(size_t(extent.rows) * extent.cols);
+        auto resultMeta = mosaic.read<float>(extent, std::span<float>(result), {.threadCount = 3});
+        CHECK(resultMeta.nodata == -1.0);
+        CHECK_CONTAINER_EQ(result, expectedData(extent));
+    }
+
+    SUBCASE("read full mosaic")
+    {
+        std::vector<float> result(data.size());
+        mosaic.read<float>(mosaic.metadata(), std::span<float>(result));
+        CHECK_CONTAINER_EQ(result, expectedData(meta));
+    }
+
+    SUBCASE("read outside of the mosaic")
+    {
+        auto extent = meta;
+        extent.xll += 10000.0;
+
+        std::vector<float> result(data.size());
+        mosaic.read<float>(extent, std::span<float>(result));
+        CHECK(std::all_of(result.begin(), result.end(), [](float value) { return value == -1.f; }));
+    }
+
+    SUBCASE("save and load the index")
+    {
+        TempDir temp("mosaic");
+        mosaic.save(temp.path() / "mosaic.idx");
+
+        auto loaded = gdal::RasterMosaic::load(temp.path() / "mosaic.idx");
+        CHECK(loaded.metadata() == mosaic.metadata());
+        REQUIRE(loaded.tiles().size() == mosaic.tiles().size());
+        for (size_t i = 0; i < mosaic.tiles().size(); ++i) {
+            CHECK(loaded.tiles()[i].path == mosaic.tiles()[i].path);
+            CHECK(loaded.tiles()[i].metadata == mosaic.tiles()[i].metadata);
+        }
+
+        std::vector<float> result(data.size());
+        loaded.read<float>(meta, std::span<float>(result));
+        CHECK_CONTAINER_EQ(result, expectedData(meta));
+    }
+
+    SUBCASE("tiles with a different cell size")
+    {
+        auto tiles = std::vector<gdal::MosaicTile>(mosaic.tiles().begin(), mosaic.tiles().end());
+        tiles.back().metadata.cellSize = GeoMetadata::CellSize(50.0, -50.0);
+        CHECK_THROWS_AS(gdal::RasterMosaic::create(std::move(tiles)), InvalidArgument);
+    }
+
+    SUBCASE("tiles with a different projection")
+    {
+        auto tiles = std::vector<gdal::MosaicTile>(mosaic.tiles().begin(), mosaic.tiles().end());
+        tiles.back().metadata.set_projection_from_epsg(4326);
+        CHECK_THROWS_AS(gdal::RasterMosaic::create(std::move(tiles)), InvalidArgument);
+    }
+}
+
+TEST_CASE("Gdal.rasterMosaicNodata")
+{
+    // two overlapping tiles of 10x10 cells with a different nodata value, the second tile is shifted 5 columns to the right
+    // the top half of the second tile is nodata, a float nodata that is not representable as double
+    const GeoMetadata meta(10, 15, 1000.0, 2000.0, GeoMetadata::CellSize(100.0, -100.0), -1.0);
+
+    auto firstMeta = meta;
+    firstMeta.cols = 10;
+    std::vector<float> firstData(100, 1.f);
+    gdal::io::write_raster(std::span<const float>(firstData), firstMeta, "/vsimem/mosaic_nodata_1.tif");
+
+    auto secondMeta   = firstMeta;
+    secondMeta.xll    = meta.xll + 500.0;
+    secondMeta.nodata = 0.1;
+    std::vector<float> secondData(100, 2.f);
+    std::fill(secondData.begin(), secondData.begin() + 50, 0.1f);
+    gdal::io::write_raster(std::span<const float>(secondData), secondMeta, "/vsimem/mosaic_nodata_2.tif");
+
+    const std::vector<fs::path> tilePaths = {"/vsimem/mosaic_nodata_1.tif", "/vsimem/mosaic_nodata_2.tif"};
+    auto mosaic                           = gdal::RasterMosaic::create(tilePaths);
+    CHECK(mosaic.metadata().nodata == -1.0);
+
+    auto expectedValue = [](int32_t row, int32_t col) {
+        if (row >= 5 && col >= 5) {
+            return 2.0;
+        }
+
+        return col < 10 ? 1.0 : -1.0;
+    };
+
+    SUBCASE("float")
+    {
+        std::vector<float> result(size_t(meta.rows) * meta.cols);
+        auto resultMeta = mosaic.read<float>(mosaic.metadata(), std::span<float>(result));
+        CHECK(resultMeta.nodata == -1.0);
+        for (int32_t row = 0; row < meta.rows; ++row) {
+            for (int32_t col = 0; col < meta.cols; ++col) {
+                CHECK(result[size_t(row) * meta.cols + col] == float(expectedValue(row, col)));
+            }
+        }
+    }
+
+    SUBCASE("double")
+    {
+        std::vector<double> result(size_t(meta.rows) * meta.cols);
+        mosaic.read<double>(mosaic.metadata(), std::span<double>(result));
+        for (int32_t row = 0; row < meta.rows; ++row) {
+            for (int32_t col = 0; col < meta.cols; ++col) {
+                CHECK(result[size_t(row) * meta.cols + col] == expectedValue(row, col));
+            }
+        }
+    }
+
+    SUBCASE("extent that is fully covered by the tile with nodata")
+    {
+        auto extent = meta;
+        extent.cols = 5;
+        extent.xll  = meta.xll + 1000.0;
+
+        std::vector<float> result(size_t(extent.rows) * extent.cols);
+        auto resultMeta = mosaic.read<float>(extent, std::span<float>(result));
+        CHECK(resultMeta.nodata == -1.0);
+        for (int32_t row = 0; row < extent.rows; ++row) {
+            for (int32_t col = 0; col < extent.cols; ++col) {
+                CHECK(result[size_t(row) * extent.cols + col] == float(expectedValue(row, col + 10)));
+            }
+        }
+    }
+}
+
+}
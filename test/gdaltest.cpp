@@ -1,9 +1,17 @@
 ﻿#include "infra/gdal.h"
 #include "infra/conversion.h"
 #include "infra/crs.h"
+#include "infra/gdalaggregate.h"
+#include "infra/gdalalgo.h"
 #include "infra/gdalio.h"
+#include "infra/gdalwarpplan.h"
+#include "infra/gdalzonalstatistics.h"
+#include "infra/test/containerasserts.h"
 
+#include <algorithm>
 #include <doctest/doctest.h>
+#include <limits>
+#include <numeric>
 
 namespace inf::test {
 
@@ -204,4 +212,482 @@ TEST_CASE("intersect metadata")
     CHECK(cutout.dstRowOffset == 1.0);
 }
 
+TEST_CASE("Gdal.multiBandIO")
+{
+    constexpr int rows  = 4;
+    constexpr int cols  = 5;
+    constexpr int cells = rows * cols;
+
+    const std::vector<std::string> driverOptions = {"INTERLEAVE=PIXEL"};
+    auto driver                                  = gdal::RasterDriver::create(gdal::RasterType::GeoTiff);
+    auto ds                                      = driver.create_dataset<uint8_t>(rows, cols, 3, "/vsimem/multiband.tif", driverOptions);
+
+    // band sequential: value = band * 50 + cell index
+    std::vector<uint8_t> bsq(cells * 3);
+    for (int band = 0; band < 3; ++band) {
+        for (int cell = 0; cell < cells; ++cell) {
+            bsq[band * cells + cell] = uint8_t(band * 50 + cell);
+        }
+    }
+
+    ds.write_rasterdata<uint8_t>(std::span<const int>(), 0, 0, cols, rows, bsq, cols, rows, gdal::BandInterleave::Band);
+
+    SUBCASE("read all bands pixel interleaved")
+    {
+        auto bip = ds.read_rasterdata<uint8_t>(std::span<const int>(), gdal::BandInterleave::Pixel);
+        REQUIRE(bip.size() == bsq.size());
+        for (int cell = 0; cell < cells; ++cell) {
+            for (int band = 0; band < 3; ++band) {
+                CHECK(bip[cell * 3 + band] == bsq[band * cells + cell]);
+            }
+        }
+    }
+
+    SUBCASE("read band subset band sequential")
+    {
+        const std::array<int, 2> bands = {3, 1};
+        std::vector<uint8_t> result(cells * 2);
+        ds.read_rasterdata<uint8_t>(bands, 0, 0, cols, rows, result, cols, rows, gdal::BandInterleave::Band);
+        CHECK(std::equal(result.begin(), result.begin() + cells, bsq.begin() + 2 * cells));
+        CHECK(std::equal(result.begin() + cells, result.end(), bsq.begin()));
+    }
+
+    SUBCASE("single band reads match")
+    {
+        for (int band = 1; band <= 3; ++band) {
+            auto bandData = ds.read_rasterdata<uint8_t>(band);
+            CHECK(std::equal(bandData.begin(), bandData.end(), bsq.begin() + (band - 1) * cells));
+        }
+    }
+
+    SUBCASE("invalid buffer size")
+    {
+        std::vector<uint8_t> result(cells);
+        CHECK_THROWS_AS(ds.read_rasterdata<uint8_t>(std::span<const int>(), 0, 0, cols, rows, result, cols, rows, gdal::BandInterleave::Pixel), InvalidArgument);
+    }
+}
+
+TEST_CASE("Gdal.warpToDiskChunked")
+{
+    const GeoMetadata meta(200, 300, 22000.0, 153000.0, 100.0, -1.0, "EPSG:31370");
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    std::iota(data.begin(), data.end(), 0.f);
+
+    auto srcDataSet = gdal::io::create_memory_dataset(std::span<const float>(data), meta);
+    auto dstMeta    = gdal::warp_metadata(meta, crs::epsg::WGS84);
+
+    gdal::WarpOptions options;
+    gdal::warp_to_disk<float>(srcDataSet, dstMeta, "/vsimem/warped.tif", options);
+
+    // a small memory limit to force warping in multiple chunks
+    gdal::WarpChunkOptions chunkOptions;
+    chunkOptions.memoryLimit = 64.0 * 1024;
+
+    SUBCASE("overlapping io")
+    {
+        chunkOptions.overlapIo = true;
+    }
+
+    SUBCASE("sequential")
+    {
+        chunkOptions.overlapIo = false;
+    }
+
+    gdal::warp_to_disk_chunked<float>(srcDataSet, dstMeta, "/vsimem/warpedchunked.tif", options, chunkOptions);
+
+    auto expected = gdal::RasterDataSet::open("/vsimem/warped.tif");
+    auto result   = gdal::RasterDataSet::open("/vsimem/warpedchunked.tif");
+    CHECK(result.geometadata() == expected.geometadata());
+    CHECK(result.read_rasterdata<float>(1) == expected.read_rasterdata<float>(1));
+
+    CHECK_THROWS_AS(gdal::warp_to_disk_chunked<float>(srcDataSet, dstMeta, "/vsimem/warped.asc", options, chunkOptions), InvalidArgument);
+}
+
+TEST_CASE("Gdal.warpPlan")
+{
+    GeoMetadata meta(100, 120, 22000.0, 153000.0, 100.0, -1.0, "EPSG:31370");
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    std::iota(data.begin(), data.end(), 0.f);
+    data[10] = -1.f;
+
+    SUBCASE("nearest neighbour matches warp_raster")
+    {
+        auto dstMeta = gdal::warp_metadata(meta, crs::epsg::WGS84);
+
+        std::vector<float> expected(size_t(dstMeta.rows) * dstMeta.cols, -1.f);
+        gdal::warp_raster<float, float>(data, meta, expected, dstMeta);
+
+        gdal::WarpPlan plan(meta, dstMeta);
+        std::vector<float> result(expected.size());
+        for (int i = 0; i < 2; ++i) {
+            // the plan can be applied multiple times
+            std::fill(result.begin(), result.end(), 0.f);
+            auto resultMeta = plan.apply<float, float>(data, result, 3);
+            CHECK(resultMeta.nodata == dstMeta.nodata);
+            CHECK(result == expected);
+        }
+    }
+
+    SUBCASE("identical grids")
+    {
+        for (auto algo : {gdal::ResampleAlgorithm::NearestNeighbour, gdal::ResampleAlgorithm::Bilinear, gdal::ResampleAlgorithm::Average}) {
+            gdal::WarpPlan plan(meta, meta, algo);
+
+            std::vector<int32_t> result(data.size());
+            auto resultMeta = plan.apply<float, int32_t>(data, result);
+            REQUIRE(resultMeta.nodata == -1.0);
+
+            for (size_t i = 0; i < data.size(); ++i) {
+                CHECK(result[i] == int32_t(data[i]));
+            }
+        }
+    }
+
+    SUBCASE("average of a coarser grid")
+    {
+        auto dstMeta = meta;
+        dstMeta.rows /= 2;
+        dstMeta.cols /= 2;
+        dstMeta.cellSize *= 2.0;
+
+        gdal::WarpPlan plan(meta, dstMeta, gdal::ResampleAlgorithm::Average);
+        std::vector<double> result(size_t(dstMeta.rows) * dstMeta.cols);
+        plan.apply<float, double>(data, result);
+
+        // the nodata cell does not contribute
+        CHECK(result[5] == Approx((data[11] + data[130] + data[131]) / 3.0));
+        CHECK(result[6] == Approx((data[12] + data[13] + data[132] + data[133]) / 4.0));
+    }
+
+    SUBCASE("float nodata that is not representable as float")
+    {
+        auto srcMeta   = meta;
+        srcMeta.nodata = -9999.9;
+        auto srcData   = data;
+        srcData[10]    = -9999.9f;
+
+        auto dstMeta = srcMeta;
+        dstMeta.rows /= 2;
+        dstMeta.cols /= 2;
+        dstMeta.cellSize *= 2.0;
+
+        gdal::WarpPlan plan(srcMeta, dstMeta, gdal::ResampleAlgorithm::Average);
+        std::vector<double> result(size_t(dstMeta.rows) * dstMeta.cols);
+        plan.apply<float, double>(srcData, result);
+        CHECK(result[5] == Approx((srcData[11] + srcData[130] + srcData[131]) / 3.0));
+
+        gdal::WarpPlan nearestPlan(srcMeta, srcMeta);
+        std::vector<double> nearestResult(srcData.size());
+        auto resultMeta = nearestPlan.apply<float, double>(srcData, nearestResult);
+        CHECK(resultMeta.nodata == -9999.9);
+        CHECK(nearestResult[10] == -9999.9);
+        CHECK(nearestResult[11] == srcData[11]);
+    }
+
+    SUBCASE("invalid arguments")
+    {
+        CHECK_THROWS_AS(gdal::WarpPlan(meta, meta, gdal::ResampleAlgorithm::Cubic), InvalidArgument);
+
+        gdal::WarpPlan plan(meta, meta);
+        std::vector<float> result(10);
+        CHECK_THROWS_AS(plan.apply<float, float>(data, result), InvalidArgument);
+    }
+}
+
+TEST_CASE("Gdal.aggregateRaster")
+{
+    // 5x7 raster aggregated with a factor 2, the last row and column of the result cover a single row/column
+    const GeoMetadata meta(5, 7, 100.0, 200.0, 10.0, -1.0);
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    std::iota(data.begin(), data.end(), 0.f);
+    data[0] = -1.f;
+
+    auto expectedMeta = gdal::aggregate_metadata(meta, 2);
+    CHECK(expectedMeta.rows == 3);
+    CHECK(expectedMeta.cols == 4);
+    CHECK(expectedMeta.xll == 100.0);
+    CHECK(expectedMeta.yll == 190.0);
+    CHECK(expectedMeta.cellSize == GeoMetadata::CellSize(20.0, -20.0));
+
+    std::vector<double> result(size_t(expectedMeta.rows) * expectedMeta.cols);
+
+    SUBCASE("average")
+    {
+        auto resultMeta = gdal::aggregate_raster<float, double>(data, meta, 2, result, gdal::ResampleAlgorithm::Average, 2);
+        CHECK(resultMeta == expectedMeta);
+        CHECK_CONTAINER_EQ(result, std::vector<double>({16.0 / 3.0, 6.0, 8.0, 9.5, 18.0, 20.0, 22.0, 23.5, 28.5, 30.5, 32.5, 34.0}));
+    }
+
+    SUBCASE("minimum")
+    {
+        gdal::aggregate_raster<float, double>(data, meta, 2, result, gdal::ResampleAlgorithm::Minimum);
+        CHECK_CONTAINER_EQ(result, std::vector<double>({1.0, 2.0, 4.0, 6.0, 14.0, 16.0, 18.0, 20.0, 28.0, 30.0, 32.0, 34.0}));
+    }
+
+    SUBCASE("maximum")
+    {
+        gdal::aggregate_raster<float, double>(data, meta, 2, result, gdal::ResampleAlgorithm::Maximum);
+        CHECK_CONTAINER_EQ(result, std::vector<double>({8.0, 10.0, 12.0, 13.0, 22.0, 24.0, 26.0, 27.0, 29.0, 31.0, 33.0, 34.0}));
+    }
+
+#if GDAL_VERSION_NUM >= 3010000
+    SUBCASE("sum")
+    {
+        // the cells of the second block are all nodata
+        auto sumData = data;
+        sumData[2] = sumData[3] = sumData[9] = sumData[10] = -1.f;
+
+        gdal::aggregate_raster<float, double>(sumData, meta, 2, result, gdal::ResampleAlgorithm::Sum);
+        CHECK_CONTAINER_EQ(result, std::vector<double>({16.0, -1.0, 32.0, 19.0, 72.0, 80.0, 88.0, 47.0, 57.0, 61.0, 65.0, 34.0}));
+    }
+#endif
+
+    SUBCASE("nearest neighbour")
+    {
+        gdal::aggregate_raster<float, double>(data, meta, 2, result, gdal::ResampleAlgorithm::NearestNeighbour);
+        CHECK_CONTAINER_EQ(result, std::vector<double>({8.0, 10.0, 12.0, 13.0, 22.0, 24.0, 26.0, 27.0, 29.0, 31.0, 33.0, 34.0}));
+    }
+
+    SUBCASE("mode")
+    {
+        std::vector<uint8_t> classes(data.size(), 3);
+        classes[1] = 5;
+        classes[7] = 5;
+        classes[8] = 5;
+
+        std::vector<int32_t> modeResult(result.size());
+        auto resultMeta = gdal::aggregate_raster<uint8_t, int32_t>(classes, GeoMetadata(5, 7, 100.0, 200.0, 10.0, {}), 2, modeResult, gdal::ResampleAlgorithm::Mode);
+        CHECK(resultMeta.nodata == std::numeric_limits<int32_t>::max());
+        CHECK(modeResult[0] == 5);
+        CHECK(std::all_of(modeResult.begin() + 1, modeResult.end(), [](int32_t value) { return value == 3; }));
+    }
+
+    SUBCASE("nodata that does not fit in the data type")
+    {
+        // the nodata value -1 can not occur in byte data, the cells with value 255 are valid
+        std::vector<uint8_t> byteData(data.size(), 255);
+        std::vector<int32_t> byteResult(result.size());
+        auto resultMeta = gdal::aggregate_raster<uint8_t, int32_t>(byteData, meta, 2, byteResult, gdal::ResampleAlgorithm::Maximum);
+        CHECK(resultMeta.nodata == -1.0);
+        CHECK(std::all_of(byteResult.begin(), byteResult.end(), [](int32_t value) { return value == 255; }));
+
+        gdal::aggregate_raster<uint8_t, int32_t>(byteData, meta, 2, byteResult, gdal::ResampleAlgorithm::NearestNeighbour);
+        CHECK(std::all_of(byteResult.begin(), byteResult.end(), [](int32_t value) { return value == 255; }));
+    }
+
+    SUBCASE("all nodata")
+    {
+        std::vector<float> nodata(data.size(), -1.f);
+        gdal::aggregate_raster<float, double>(nodata, meta, 3, std::span<double>(result.data(), 6), gdal::ResampleAlgorithm::Average);
+        CHECK(std::all_of(result.begin(), result.begin() + 6, [](double value) { return value == -1.0; }));
+    }
+
+    SUBCASE("invalid arguments")
+    {
+        CHECK_THROWS_AS(gdal::aggregate_metadata(meta, 0), InvalidArgument);
+        CHECK_THROWS_AS((gdal::aggregate_raster<float, double>(data, meta, 3, result, gdal::ResampleAlgorithm::Average)), InvalidArgument);
+        CHECK_THROWS_AS((gdal::aggregate_raster<float, double>(data, meta, 2, result, gdal::ResampleAlgorithm::Bilinear)), InvalidArgument);
+    }
+}
+
+TEST_CASE("Gdal.rasterizeTiled")
+{
+    const GeoMetadata meta(40, 50, 22000.0, 153000.0, 100.0, -1.0, "EPSG:31370");
+    std::vector<int32_t> data(size_t(meta.rows) * meta.cols);
+    for (int32_t r = 0; r < meta.rows; ++r) {
+        for (int32_t c = 0; c < meta.cols; ++c) {
+            data[size_t(r) * meta.cols + c] = (r > 30 && c > 40) ? -1 : (r / 8) * 10 + c / 9;
+        }
+    }
+
+    const fs::path vectorPath = "/vsimem/rasterize_tiled.gpkg";
+    gdal::translate_vector_to_disk(gdal::polygonize(std::span<const int32_t>(data), meta), vectorPath, {"-f", "GPKG"});
+
+    const std::vector<std::string> options{"-a", "Value"};
+    auto expected = gdal::rasterize<int32_t>(gdal::VectorDataSet::open(vectorPath), meta, options);
+    CHECK(expected.second == data);
+
+    gdal::RasterizeTileOptions tileOptions;
+    tileOptions.tileSize    = 16;
+    tileOptions.threadCount = 3;
+
+    SUBCASE("in memory")
+    {
+        std::vector<int32_t> result(data.size());
+        auto resultMeta = gdal::rasterize_tiled<int32_t>(vectorPath, meta, result, options, tileOptions);
+        CHECK(resultMeta == meta);
+        CHECK(result == data);
+    }
+
+    SUBCASE("to disk")
+    {
+        gdal::rasterize_tiled_to_disk<int32_t>(vectorPath, meta, "/vsimem/rasterize_tiled.tif", options, tileOptions);
+
+        auto ds = gdal::RasterDataSet::open("/vsimem/rasterize_tiled.tif");
+        CHECK(ds.geometadata() == meta);
+        CHECK(ds.read_rasterdata<int32_t>(1) == data);
+    }
+
+    SUBCASE("invalid tile size")
+    {
+        std::vector<int32_t> result(data.size());
+        tileOptions.tileSize = 0;
+        CHECK_THROWS_AS(gdal::rasterize_tiled<int32_t>(vectorPath, meta, result, options, tileOptions), InvalidArgument);
+    }
+}
+
+static gdal::Owner<gdal::PolygonRef> create_rect_polygon(Point<double> topLeft, Point<double> bottomRight)
+{
+    auto ring = gdal::Geometry::create<gdal::Geometry::Type::LinearRing>();
+    ring.add_point(topLeft.x, topLeft.y);
+    ring.add_point(bottomRight.x, topLeft.y);
+    ring.add_point(bottomRight.x, bottomRight.y);
+    ring.add_point(topLeft.x, bottomRight.y);
+    ring.add_point(topLeft.x, topLeft.y);
+
+    auto polygon = gdal::Geometry::create<gdal::Geometry::Type::Polygon>();
+    polygon.add_ring(std::move(ring));
+    return polygon;
+}
+
+TEST_CASE("Gdal.zonalStatistics")
+{
+    const GeoMetadata meta(10, 10, 0.0, 0.0, 1.0, -1.0);
+    std::vector<int32_t> data(size_t(meta.rows) * meta.cols);
+    for (int32_t r = 0; r < meta.rows; ++r) {
+        for (int32_t c = 0; c < meta.cols; ++c) {
+            data[size_t(r) * meta.cols + c] = c;
+        }
+    }
+    data[6 * meta.cols + 3] = -1;
+
+    auto memDriver = gdal::VectorDriver::create(gdal::VectorType::Memory);
+    auto ds        = memDriver.create_dataset();
+    auto layer     = ds.create_layer("Zones", gdal::Geometry::Type::Polygon);
+
+    {
+        // rows 5-7, columns 2-4 of the raster
+        gdal::Feature feature(layer.layer_definition());
+        feature.set_geometry(create_rect_polygon(Point(2.0, 5.0), Point(5.0, 2.0)));
+        layer.create_feature(feature);
+    }
+
+    {
+        // partially outside of the raster
+        gdal::Feature feature(layer.layer_definition());
+        feature.set_geometry(create_rect_polygon(Point(8.25, 12.0), Point(12.0, 8.25)));
+        layer.create_feature(feature);
+    }
+
+    {
+        // no geometry
+        gdal::Feature feature(layer.layer_definition());
+        layer.create_feature(feature);
+    }
+
+    gdal::ZonalStatisticsOptions options;
+    options.majority    = true;
+    options.threadCount = 2;
+
+    SUBCASE("cell centres")
+    {
+        auto stats = gdal::zonal_statistics(std::span<const int32_t>(data), meta, layer, options);
+        REQUIRE(stats.size() == 3);
+
+        CHECK(stats[0].count == 8.0);
+        CHECK(stats[0].sum == 24.0);
+        CHECK(stats[0].mean == 3.0);
+        CHECK(stats[0].min == 2.0);
+        CHECK(stats[0].max == 4.0);
+        CHECK(stats[0].majority == 2.0);
+
+        CHECK(stats[1].count == 4.0);
+        CHECK(stats[1].sum == 34.0);
+        CHECK(stats[1].min == 8.0);
+        CHECK(stats[1].max == 9.0);
+
+        CHECK(stats[2].count == 0.0);
+        CHECK(std::isnan(stats[2].mean));
+        CHECK(std::isnan(stats[2].majority));
+
+        CHECK(stats[0].fid != stats[1].fid);
+        CHECK(stats[1].fid != stats[2].fid);
+    }
+
+    SUBCASE("coverage weighting")
+    {
+        options.coverageWeighting = true;
+        auto stats                = gdal::zonal_statistics(std::span<const int32_t>(data), meta, layer, options);
+        REQUIRE(stats.size() == 3);
+
+        CHECK(stats[0].count == Approx(8.0));
+        CHECK(stats[0].sum == Approx(24.0));
+
+        CHECK(stats[1].count == Approx(3.0625));
+        CHECK(stats[1].sum == Approx(26.25));
+        CHECK(stats[1].majority == 9.0);
+    }
+
+    SUBCASE("raster on disk")
+    {
+        gdal::io::write_raster(std::span<const int32_t>(data), meta, "/vsimem/zonal_statistics.tif");
+
+        int64_t ticks   = 0;
+        auto progressCb = [&](ProgressInfo::Status) {
+            ++ticks;
+            return ProgressStatusResult::Continue;
+        };
+
+        auto stats    = gdal::zonal_statistics("/vsimem/zonal_statistics.tif", 1, layer, options, progressCb);
+        auto expected = gdal::zonal_statistics(std::span<const int32_t>(data), meta, layer, options);
+
+        CHECK(ticks == 3);
+        REQUIRE(stats.size() == expected.size());
+        for (size_t i = 0; i < stats.size(); ++i) {
+            CHECK(stats[i].fid == expected[i].fid);
+            CHECK(stats[i].count == expected[i].count);
+            CHECK(stats[i].sum == expected[i].sum);
+        }
+    }
+
+    SUBCASE("float nodata that is not representable as float")
+    {
+        auto floatMeta   = meta;
+        floatMeta.nodata = 0.1;
+
+        std::vector<float> floatData(data.begin(), data.end());
+        std::replace(floatData.begin(), floatData.end(), -1.f, 0.1f);
+
+        auto stats = gdal::zonal_statistics(std::span<const float>(floatData), floatMeta, layer, options);
+        CHECK(stats[0].count == 8.0);
+        CHECK(stats[0].sum == 24.0);
+        CHECK(stats[0].min == 2.0);
+
+        gdal::io::write_raster(std::span<const float>(floatData), floatMeta, "/vsimem/zonal_statistics_float.tif");
+        stats = gdal::zonal_statistics("/vsimem/zonal_statistics_float.tif", 1, layer, options);
+        CHECK(stats[0].count == 8.0);
+        CHECK(stats[0].sum == 24.0);
+        CHECK(stats[0].min == 2.0);
+    }
+
+    SUBCASE("cancel")
+    {
+        auto progressCb = [](ProgressInfo::Status) { return ProgressStatusResult::Abort; };
+        CHECK_THROWS_AS(gdal::zonal_statistics(std::span<const int32_t>(data), meta, layer, options, progressCb), CancelRequested);
+    }
+
+    SUBCASE("write fields")
+    {
+        auto stats = gdal::zonal_statistics(std::span<const int32_t>(data), meta, layer, options);
+        gdal::write_zonal_statistics(layer, stats, options, "zs_");
+
+        auto feature = layer.feature(stats[0].fid);
+        CHECK(feature.field_as<double>("zs_mean") == 3.0);
+        CHECK(feature.field_as<double>("zs_majority") == 2.0);
+
+        auto empty = layer.feature(stats[2].fid);
+        CHECK(!empty.field_is_valid(empty.field_index("zs_mean")));
+    }
+}
+
 }
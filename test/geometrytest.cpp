@@ -0,0 +1,77 @@
+#include "infra/gdalalgo.h"
+#include "infra/gdalio.h"
+#include "infra/geometry.h"
+
+#include <doctest/doctest.h>
+#include <map>
+
+namespace inf::test {
+
+using namespace doctest;
+
+static std::map<int32_t, std::pair<int32_t, double>> polygon_count_and_area_per_value(gdal::Layer layer)
+{
+    std::map<int32_t, std::pair<int32_t, double>> result;
+    for (auto& feature : layer) {
+        auto& [count, area] = result[feature.field_as<int32_t>(feature.field_index("Value"))];
+        ++count;
+        area += OGR_G_Area(feature.geometry().get());
+    }
+
+    return result;
+}
+
+static void check_polygonize_tiled(const GeoMetadata& meta, const fs::path& rasterPath)
+{
+    // patches of values that cross the tile seams, including a ring shaped patch around another value
+    std::vector<int32_t> data(size_t(meta.rows) * meta.cols);
+    for (int32_t r = 0; r < meta.rows; ++r) {
+        for (int32_t c = 0; c < meta.cols; ++c) {
+            int32_t value = (r / 8) * 10 + c / 9 + 1;
+            if (r >= 10 && r < 30 && c >= 10 && c < 30) {
+                value = (r >= 15 && r < 25 && c >= 15 && c < 25) ? 100 : 200;
+            }
+
+            data[size_t(r) * meta.cols + c] = value;
+        }
+    }
+
+    gdal::io::write_raster(std::span<const int32_t>(data), meta, rasterPath);
+
+    auto expected = gdal::polygonize(std::span<const int32_t>(data), meta);
+
+    auto memDriver = gdal::VectorDriver::create(gdal::VectorType::Memory);
+    auto resultDs  = memDriver.create_dataset();
+    auto layer     = resultDs.create_layer("Polygons");
+
+    geom::PolygonizeTileOptions options;
+    options.tileSize    = 12;
+    options.threadCount = 3;
+    geom::polygonize_tiled(rasterPath, layer, options);
+
+    auto expectedPolygons = polygon_count_and_area_per_value(expected.layer(0));
+    auto resultPolygons   = polygon_count_and_area_per_value(layer);
+
+    REQUIRE(resultPolygons.size() == expectedPolygons.size());
+    for (auto& [value, countAndArea] : expectedPolygons) {
+        INFO("Value: " << value);
+        CHECK(resultPolygons[value].first == countAndArea.first);
+        CHECK(resultPolygons[value].second == Approx(countAndArea.second));
+    }
+}
+
+TEST_CASE("Geometry.polygonizeTiled")
+{
+    SUBCASE("metric cell size")
+    {
+        check_polygonize_tiled(GeoMetadata(40, 50, 22000.0, 153000.0, 100.0, -1.0, "EPSG:31370"), "/vsimem/polygonize_tiled.tif");
+    }
+
+    SUBCASE("cell size that is not exact in binary")
+    {
+        // the tile edges only match when the seam coordinates are computed from the global grid
+        check_polygonize_tiled(GeoMetadata(40, 50, 4.3, 50.7, 0.1, -1.0, "EPSG:4326"), "/vsimem/polygonize_tiled_decimal.tif");
+    }
+}
+
+}
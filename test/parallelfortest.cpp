@@ -0,0 +1,86 @@
+#include "infra/parallelfor.h"
+
+#include <atomic>
+#include <doctest/doctest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace inf::test {
+
+TEST_CASE("ParallelFor.allIndexesProcessed")
+{
+    std::vector<int> processed(1000, 0);
+    parallel_for(1000, 4, [&](int64_t index) {
+        ++processed[index];
+    });
+
+    for (auto count : processed) {
+        CHECK(count == 1);
+    }
+}
+
+TEST_CASE("ParallelFor.emptyRange")
+{
+    bool invoked = false;
+    parallel_for(0, 4, [&](int64_t) { invoked = true; });
+    CHECK_FALSE(invoked);
+}
+
+TEST_CASE("ParallelFor.statePerThread")
+{
+    std::atomic<int> stateCount = 0;
+    std::vector<int> processed(100, 0);
+
+    parallel_for(
+        100, 3,
+        [&]() {
+            ++stateCount;
+            return std::vector<int>();
+        },
+        [&](std::vector<int>& state, int64_t index) {
+            state.push_back(int(index));
+            ++processed[index];
+        });
+
+    CHECK(stateCount <= 3);
+    for (auto count : processed) {
+        CHECK(count == 1);
+    }
+}
+
+TEST_CASE("ParallelFor.nested")
+{
+    // the inner calls run on the threads of the shared pool, they must not wait for jobs that never start
+    std::atomic<int64_t> processed = 0;
+    parallel_for(16, 4, [&](int64_t) {
+        parallel_for(100, 4, [&](int64_t) {
+            ++processed;
+        });
+    });
+
+    CHECK(processed == 1600);
+}
+
+TEST_CASE("ParallelFor.repeatedCalls")
+{
+    std::atomic<int64_t> processed = 0;
+    for (int i = 0; i < 1000; ++i) {
+        parallel_for(8, 4, [&](int64_t) {
+            ++processed;
+        });
+    }
+
+    CHECK(processed == 8000);
+}
+
+TEST_CASE("ParallelFor.exceptionIsRethrown")
+{
+    CHECK_THROWS_AS(parallel_for(100, 4, [](int64_t index) {
+                        if (index == 50) {
+                            throw std::runtime_error("fail");
+                        }
+                    }),
+                    std::runtime_error);
+}
+
+}
@@ -0,0 +1,182 @@
+#include "infra/rasterstatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <doctest/doctest.h>
+#include <limits>
+#include <vector>
+
+namespace inf::test {
+
+using namespace doctest;
+
+TEST_CASE("RasterStatistics.moments")
+{
+    // large enough to be processed in multiple blocks
+    GeoMetadata meta(700, 1000, 0.0, 0.0, {1.0, -1.0}, -1.0);
+    std::vector<float> data(size_t(meta.rows) * meta.cols);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = float(i % 1000) / 10.f;
+    }
+
+    for (size_t i = 0; i < data.size(); i += 7) {
+        data[i] = -1.f;
+    }
+
+    data[3] = std::numeric_limits<float>::quiet_NaN();
+
+    uint64_t count = 0;
+    double sum     = 0.0;
+    for (auto value : data) {
+        if (!std::isnan(value) && value != -1.f) {
+            ++count;
+            sum += value;
+        }
+    }
+
+    const auto mean = sum / double(count);
+    double m2       = 0.0;
+    for (auto value : data) {
+        if (!std::isnan(value) && value != -1.f) {
+            m2 += (value - mean) * (value - mean);
+        }
+    }
+
+    auto stats = compute_statistics(meta, std::span<const float>(data));
+    CHECK(stats.count == count);
+    CHECK(stats.nodataCount == data.size() - count);
+    CHECK(stats.min == 0.0);
+    CHECK(stats.max == Approx(99.9));
+    CHECK(stats.sum == Approx(sum));
+    CHECK(stats.mean == Approx(mean));
+    CHECK(stats.stddev == Approx(std::sqrt(m2 / double(count))));
+
+    StatisticsOptions singleThreaded;
+    singleThreaded.threadCount = 1;
+    auto singleThreadedStats   = compute_statistics(meta, std::span<const float>(data), singleThreaded);
+    CHECK(singleThreadedStats.mean == stats.mean);
+    CHECK(singleThreadedStats.stddev == stats.stddev);
+}
+
+TEST_CASE("RasterStatistics.histogramAndPercentiles")
+{
+    GeoMetadata meta(10, 10, 0.0, 0.0, {1.0, -1.0}, {});
+    std::vector<int32_t> data(100);
+    for (int32_t i = 0; i < 100; ++i) {
+        data[i] = i + 1;
+    }
+
+    StatisticsOptions options;
+    options.histogramBins = 4;
+    options.histogramMin  = 0.0;
+    options.histogramMax  = 80.0;
+    options.percentiles   = {0.0, 50.0, 90.0, 100.0};
+
+    auto stats = compute_statistics(meta, std::span<const int32_t>(data), options);
+    REQUIRE(stats.histogram.size() == 4);
+    CHECK(stats.histogram[0] == 19); // 1 - 19
+    CHECK(stats.histogram[1] == 20); // 20 - 39
+    CHECK(stats.histogram[2] == 20); // 40 - 59
+    CHECK(stats.histogram[3] == 21); // 60 - 80, the maximum is included in the last bin
+
+    REQUIRE(stats.percentiles.size() == 4);
+    CHECK(stats.percentiles[0] == 1.0);
+    CHECK(stats.percentiles[1] == Approx(50.0).epsilon(0.01));
+    CHECK(stats.percentiles[2] == Approx(90.0).epsilon(0.01));
+    CHECK(stats.percentiles[3] == Approx(100.0).epsilon(0.01));
+}
+
+TEST_CASE("RasterStatistics.mask")
+{
+    GeoMetadata meta(2, 3, 0.0, 0.0, {1.0, -1.0}, 0.0);
+    std::vector<uint8_t> data = {1, 2, 0, 4, 5, 6};
+    std::vector<uint8_t> mask = {1, 0, 1, 1, 0, 0};
+
+    auto stats = compute_statistics(meta, std::span<const uint8_t>(data), std::span<const uint8_t>(mask));
+    CHECK(stats.count == 2);
+    CHECK(stats.nodataCount == 1);
+    CHECK(stats.min == 1.0);
+    CHECK(stats.max == 4.0);
+    CHECK(stats.mean == 2.5);
+    CHECK(stats.stddev == 1.5);
+}
+
+TEST_CASE("RasterStatistics.noData")
+{
+    GeoMetadata meta(1, 3, 0.0, 0.0, {1.0, -1.0}, 0.0);
+    std::vector<float> data = {0.f, 0.f, std::numeric_limits<float>::quiet_NaN()};
+
+    StatisticsOptions options;
+    options.percentiles = {50.0};
+
+    auto stats = compute_statistics(meta, std::span<const float>(data), options);
+    CHECK(stats.count == 0);
+    CHECK(stats.nodataCount == 3);
+    CHECK(std::isnan(stats.mean));
+    CHECK(std::isnan(stats.percentiles.front()));
+}
+
+TEST_CASE("RasterStatistics.floatNoDataNotRepresentableAsDouble")
+{
+    // 0.1 is not exact as float, the nodata is compared in the type of the data
+    GeoMetadata meta(1, 4, 0.0, 0.0, {1.0, -1.0}, 0.1);
+    std::vector<float> data = {0.1f, 1.f, 2.f, 0.1f};
+
+    auto stats = compute_statistics(meta, std::span<const float>(data));
+    CHECK(stats.count == 2);
+    CHECK(stats.nodataCount == 2);
+    CHECK(stats.min == 1.0);
+    CHECK(stats.mean == 1.5);
+
+    // a nodata value that is not an integer does not match integral data
+    GeoMetadata intMeta(1, 2, 0.0, 0.0, {1.0, -1.0}, 1.5);
+    std::vector<int32_t> intData = {1, 2};
+    CHECK(compute_statistics(intMeta, std::span<const int32_t>(intData)).count == 2);
+}
+
+TEST_CASE("RasterStatistics.infiniteValues")
+{
+    GeoMetadata meta(1, 102, 0.0, 0.0, {1.0, -1.0}, {});
+    std::vector<float> data;
+    for (int32_t i = 1; i <= 100; ++i) {
+        data.push_back(float(i));
+    }
+
+    data.push_back(std::numeric_limits<float>::infinity());
+    data.push_back(-std::numeric_limits<float>::infinity());
+
+    StatisticsOptions options;
+    options.histogramBins = 2;
+    options.histogramMin  = 0.0;
+    options.histogramMax  = 100.0;
+    options.percentiles   = {0.0, 50.0, 100.0};
+
+    auto stats = compute_statistics(meta, std::span<const float>(data), options);
+    CHECK(stats.count == 102);
+    CHECK(stats.min == -std::numeric_limits<double>::infinity());
+    CHECK(stats.max == std::numeric_limits<double>::infinity());
+
+    // infinite values are outside of the histogram range
+    CHECK(stats.histogram[0] + stats.histogram[1] == 100);
+
+    REQUIRE(stats.percentiles.size() == 3);
+    CHECK(stats.percentiles[0] == -std::numeric_limits<double>::infinity());
+    CHECK(stats.percentiles[1] == Approx(50.0).epsilon(0.02));
+    CHECK(stats.percentiles[2] == std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("RasterStatistics.invalidOptions")
+{
+    GeoMetadata meta(1, 1, 0.0, 0.0, {1.0, -1.0}, {});
+    std::vector<float> data = {1.f};
+
+    StatisticsOptions options;
+    options.histogramBins = 10;
+    CHECK_THROWS_AS(compute_statistics(meta, std::span<const float>(data), options), InvalidArgument);
+
+    options.histogramBins = 0;
+    options.percentiles   = {101.0};
+    CHECK_THROWS_AS(compute_statistics(meta, std::span<const float>(data), options), InvalidArgument);
+}
+
+}
@@ -0,0 +1,125 @@
+#include "infra/simdcast.h"
+
+#include <cmath>
+#include <doctest/doctest.h>
+#include <limits>
+#include <vector>
+
+namespace inf::test {
+
+static constexpr float s_nan = std::numeric_limits<float>::quiet_NaN();
+
+// sizes that cover the vectorized part and the scalar remainder
+static const std::vector<size_t> s_sizes = {0, 1, 3, 4, 7, 8, 9, 17, 33};
+
+template <typename T>
+static std::vector<T> create_data(size_t size)
+{
+    std::vector<T> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<T>((i * 37) % 250);
+    }
+
+    return data;
+}
+
+template <typename TSource, typename TDest>
+static void check_cast()
+{
+    for (auto size : s_sizes) {
+        auto src = create_data<TSource>(size);
+        std::vector<TDest> dst(size);
+        simd::cast(std::span<const TSource>(src), std::span<TDest>(dst));
+
+        for (size_t i = 0; i < size; ++i) {
+            CHECK(dst[i] == static_cast<TDest>(src[i]));
+        }
+    }
+}
+
+TEST_CASE("SimdCast.cast")
+{
+    check_cast<float, double>();
+    check_cast<double, float>();
+    check_cast<int32_t, float>();
+    check_cast<float, int32_t>();
+    check_cast<uint8_t, float>();
+    check_cast<float, uint8_t>();
+}
+
+TEST_CASE("SimdCast.castFractions")
+{
+    std::vector<float> src = {0.5f, 1.9f, -1.9f, 254.99f, -0.5f, 3.5f, 7.25f, 100.75f, 12.1f};
+
+    std::vector<int32_t> intResult(src.size());
+    simd::cast(std::span<const float>(src), std::span<int32_t>(intResult));
+    for (size_t i = 0; i < src.size(); ++i) {
+        CHECK(intResult[i] == static_cast<int32_t>(src[i]));
+    }
+
+    std::vector<double> doubleSrc = {0.1, 1e-50, 3e38, -3.3, 16777217.0, 0.3, 2.5, 1.0 / 3.0, 7.7};
+    std::vector<float> floatResult(doubleSrc.size());
+    simd::cast(std::span<const double>(doubleSrc), std::span<float>(floatResult));
+    for (size_t i = 0; i < doubleSrc.size(); ++i) {
+        CHECK(floatResult[i] == static_cast<float>(doubleSrc[i]));
+    }
+}
+
+TEST_CASE("SimdCast.nodataToNan")
+{
+    for (auto size : s_sizes) {
+        auto intSrc  = create_data<int32_t>(size);
+        auto byteSrc = create_data<uint8_t>(size);
+        std::vector<float> dst(size);
+
+        simd::cast_nodata_to_nan(std::span<const int32_t>(intSrc), 37, std::span<float>(dst));
+        for (size_t i = 0; i < size; ++i) {
+            if (intSrc[i] == 37) {
+                CHECK(std::isnan(dst[i]));
+            } else {
+                CHECK(dst[i] == static_cast<float>(intSrc[i]));
+            }
+        }
+
+        simd::cast_nodata_to_nan(std::span<const uint8_t>(byteSrc), uint8_t(74), std::span<float>(dst));
+        for (size_t i = 0; i < size; ++i) {
+            if (byteSrc[i] == 74) {
+                CHECK(std::isnan(dst[i]));
+            } else {
+                CHECK(dst[i] == static_cast<float>(byteSrc[i]));
+            }
+        }
+    }
+}
+
+TEST_CASE("SimdCast.nanToNodata")
+{
+    for (auto size : s_sizes) {
+        auto src = create_data<float>(size);
+        for (size_t i = 0; i < size; i += 3) {
+            src[i] = s_nan;
+        }
+
+        std::vector<int32_t> intDst(size);
+        simd::cast_nan_to_nodata(std::span<const float>(src), 37.f, -1, std::span<int32_t>(intDst));
+
+        std::vector<uint8_t> byteDst(size);
+        simd::cast_nan_to_nodata(std::span<const float>(src), s_nan, uint8_t(255), std::span<uint8_t>(byteDst));
+
+        for (size_t i = 0; i < size; ++i) {
+            if (std::isnan(src[i]) || src[i] == 37.f) {
+                CHECK(intDst[i] == -1);
+            } else {
+                CHECK(intDst[i] == static_cast<int32_t>(src[i]));
+            }
+
+            if (std::isnan(src[i])) {
+                CHECK(byteDst[i] == 255);
+            } else {
+                CHECK(byteDst[i] == static_cast<uint8_t>(src[i]));
+            }
+        }
+    }
+}
+
+}
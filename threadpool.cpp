@@ -149,7 +149,7 @@ void ThreadPool::add_job(std::function<void()> job)
 {
     {
         std::lock_guard<std::mutex> lock(_jobsMutex);
-        _queuedJobs.push_back(job);
+        _queuedJobs.push_back(std::move(job));
     }
 
     {
@@ -165,7 +165,7 @@ std::function<void()> ThreadPool::get_job()
     {
         std::lock_guard<std::mutex> lock(_jobsMutex);
         if (!_queuedJobs.empty()) {
-            job = _queuedJobs.front();
+            job = std::move(_queuedJobs.front());
             _queuedJobs.pop_front();
         }
     }